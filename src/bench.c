@@ -0,0 +1,528 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <raymath.h>
+
+#include "bitplane.h"
+#include "colorlife.h"
+#include "field.h"
+#include "kociemba.h"
+#include "random.h"
+#include "rubik.h"
+#include "tiled.h"
+#include "vectors.h"
+#include "workers.h"
+
+// Size of the viewport, matches the default window.
+#define BENCH_VIEWPORT 1000
+// Number of the viewport positions, viewport jumps over the field.
+#define BENCH_FRAMES   64
+// Number of the random moves replayed by the Rubik's cube benchmark and
+// the time spent on every cube size.
+#define BENCH_MOVES    4096
+#define BENCH_SECONDS  0.25
+// Number of the random 3x3x3 scrambles solved by the benchmark, their
+// length and the longest solution the solver looks for.
+#define BENCH_SCRAMBLES 100
+#define BENCH_SCRAMBLE  40
+#define BENCH_SOLUTION  22
+
+// Number of the passes over the lattice of the vector benchmark.
+#define BENCH_PASSES    16
+
+// File of the solver tables when they are not embedded.
+#define BENCH_TABLES    "kociemba.tables"
+
+// benchNow returns monotonic time in seconds.
+local f64 benchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// benchRowMajorViewport copies viewport of the row-major field.
+local void benchRowMajorViewport(Field* field, i32 x, i32 y, u32 width, u32 height,
+    u8* states) {
+  for (u32 row = 0; row < height; row++) {
+    const u8* cells = field->current
+      + (usize)modi32(y + (i32)row, field->height) * field->pitch;
+    u8* out = states + (usize)row * width;
+
+    for (u32 column = 0; column < width;) {
+      i32 cx  = modi32(x + (i32)column, field->width);
+      u32 run = min_value(field->width - cx, width - column);
+      memcpy(out + column, cells + cx, run);
+      column += run;
+    }
+  }
+}
+
+// benchChecksum mixes states of the viewport, so extraction is never
+// optimized out.
+local u64 benchChecksum(const u8* states, usize count) {
+  u64 sum = 0;
+  for (usize i = 0; i < count; i++) {
+    sum = sum * 31 + states[i];
+  }
+  return sum;
+}
+
+void benchLayout(u32 width, u32 height, u32 generations) {
+  printf("Layout benchmark: %ux%u cells, %u generations\n", width, height, generations);
+
+  Field field;
+  fieldInit(&field, width, height);
+  fieldRandomize(&field, 0.35, 1);
+
+  TiledField tiled;
+  tiledFieldInit(&tiled, width, height, field.rule);
+  tiledFieldFromField(&tiled, &field);
+
+  f64 start = benchNow();
+  for (u32 i = 0; i < generations; i++) {
+    fieldUpdate(&field);
+  }
+  f64 row_major = benchNow() - start;
+
+  start = benchNow();
+  for (u32 i = 0; i < generations; i++) {
+    tiledFieldUpdate(&tiled);
+  }
+  f64 tiles = benchNow() - start;
+
+  Field check;
+  fieldInit(&check, width, height);
+  tiledFieldToField(&tiled, &check);
+  bool same = memcmp(check.current, field.current, (usize)field.pitch * height) == 0;
+  fieldFree(&check);
+
+  printf("  update   row-major %8.3f ms/gen, tiled %8.3f ms/gen%s\n",
+      row_major * 1e3 / generations, tiles * 1e3 / generations,
+      same ? "" : " (MISMATCH)");
+
+  u32 view_width  = min_value(width, BENCH_VIEWPORT);
+  u32 view_height = min_value(height, BENCH_VIEWPORT);
+  usize view_size = (usize)view_width * view_height;
+  u8* states      = gmalloc(view_size);
+  u64 row_sum     = 0;
+  u64 tiled_sum   = 0;
+
+  start = benchNow();
+  for (u32 frame = 0; frame < BENCH_FRAMES; frame++) {
+    i32 x = (u64)frame * 7919 % width;
+    i32 y = (u64)frame * 104729 % height;
+    benchRowMajorViewport(&field, x, y, view_width, view_height, states);
+    row_sum += benchChecksum(states, view_size);
+  }
+  row_major = benchNow() - start;
+
+  start = benchNow();
+  for (u32 frame = 0; frame < BENCH_FRAMES; frame++) {
+    i32 x = (u64)frame * 7919 % width;
+    i32 y = (u64)frame * 104729 % height;
+    tiledFieldViewport(&tiled, x, y, view_width, view_height, states);
+    tiled_sum += benchChecksum(states, view_size);
+  }
+  tiles = benchNow() - start;
+
+  printf("  viewport row-major %8.3f ms/frame, tiled %8.3f ms/frame%s\n",
+      row_major * 1e3 / BENCH_FRAMES, tiles * 1e3 / BENCH_FRAMES,
+      row_sum == tiled_sum ? "" : " (MISMATCH)");
+
+  gfree(states);
+  tiledFieldFree(&tiled);
+  fieldFree(&field);
+}
+
+local i32 benchComparePointers(const void* a, const void* b) {
+  usize pa = (usize)*(void* const*)a;
+  usize pb = (usize)*(void* const*)b;
+  return (pa > pb) - (pa < pb);
+}
+
+// benchDistinctTiles returns number of the distinct tiles of the current
+// generations of both fields.
+local u32 benchDistinctTiles(TiledField* a, TiledField* b) {
+  u32 count = a->tiles_x * a->tiles_y;
+  TiledTile** tiles = gmalloc(2 * count * sizeof(TiledTile*));
+  memcpy(tiles, a->current, count * sizeof(TiledTile*));
+  memcpy(tiles + count, b->current, count * sizeof(TiledTile*));
+  qsort(tiles, 2 * count, sizeof(TiledTile*), benchComparePointers);
+
+  u32 distinct = 0;
+  for (u32 i = 0; i < 2 * count; i++) {
+    distinct += i == 0 || tiles[i] != tiles[i - 1];
+  }
+  gfree(tiles);
+  return distinct;
+}
+
+void benchFork(u32 width, u32 height, u32 generations) {
+  printf("Fork benchmark: %ux%u cells, %u generations\n", width, height, generations);
+
+  // Soup covers the square in the middle, the rest of the field is empty
+  // as in the most of the large patterns.
+  Field field;
+  fieldInit(&field, width, height);
+  u32 side = min_value(width, height) / 4;
+  u16 values[BENCH_VIEWPORT];
+  for (u32 y = 0; y < side; y++) {
+    for (u32 x = 0; x < side; x += BENCH_VIEWPORT) {
+      u32 count = min_value(side - x, BENCH_VIEWPORT);
+      randomFill16(1, y, x, values, count);
+      for (u32 i = 0; i < count; i++) {
+        if (values[i] < 0x10000 * 0.35) {
+          fieldCellSet(&field, (width - side) / 2 + x + i, (height - side) / 2 + y, ALIVE);
+        }
+      }
+    }
+  }
+
+  TiledField parent;
+  tiledFieldInit(&parent, width, height, field.rule);
+  tiledFieldFromField(&parent, &field);
+
+  f64 start = benchNow();
+  TiledField fork;
+  tiledFieldFork(&fork, &parent);
+  f64 forking = benchNow() - start;
+
+  start = benchNow();
+  TiledField copy;
+  tiledFieldInit(&copy, width, height, field.rule);
+  tiledFieldToField(&parent, &field);
+  tiledFieldFromField(&copy, &field);
+  f64 copying = benchNow() - start;
+
+  // The same edit goes to the fork and to the full copy, they must stay
+  // the same while the parent goes its own way.
+  for (i32 y = -4; y < 4; y++) {
+    for (i32 x = -4; x < 4; x++) {
+      tiledFieldCellSet(&fork, width / 2 + x, height / 2 + y, ALIVE);
+      tiledFieldCellSet(&copy, width / 2 + x, height / 2 + y, ALIVE);
+    }
+  }
+
+  u32 tiles = parent.tiles_x * parent.tiles_y;
+  printf("  fork %8.3f ms, full copy %8.3f ms\n", forking * 1e3, copying * 1e3);
+  printf("  %6u generations: %u distinct tiles of %u\n", 0,
+      benchDistinctTiles(&parent, &fork), 2 * tiles);
+
+  start = benchNow();
+  for (u32 g = 1; g <= generations; g++) {
+    tiledFieldUpdate(&parent);
+    tiledFieldUpdate(&fork);
+    if ((g & (g - 1)) == 0 || g == generations) {
+      printf("  %6u generations: %u distinct tiles of %u\n", g,
+          benchDistinctTiles(&parent, &fork), 2 * tiles);
+    }
+  }
+  f64 updates = benchNow() - start;
+
+  for (u32 g = 0; g < generations; g++) {
+    tiledFieldUpdate(&copy);
+  }
+
+  Field check;
+  fieldInit(&check, width, height);
+  tiledFieldToField(&fork, &check);
+  tiledFieldToField(&copy, &field);
+  bool same = memcmp(check.current, field.current, (usize)field.pitch * height) == 0;
+  fieldFree(&check);
+
+  printf("  update of the parent and the fork %8.3f ms/gen%s\n",
+      updates * 1e3 / generations, same ? "" : " (MISMATCH)");
+
+  tiledFieldFree(&copy);
+  tiledFieldFree(&fork);
+  tiledFieldFree(&parent);
+  fieldFree(&field);
+}
+
+void benchRubik(void) {
+  printf("Rubik's cube benchmark: %u random layer moves\n", BENCH_MOVES);
+
+  const u32 sizes[] = { 3, 4, 5, 7, 10, 17, 33, 50, 100 };
+  RubikMove* moves  = gmalloc(BENCH_MOVES * sizeof(RubikMove));
+
+  for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    u32 size = sizes[s];
+    RubikCube cube;
+    rubikInit(&cube, size);
+    rubikRandomMoves(size, size, moves, BENCH_MOVES);
+
+    u64 count = 0;
+    f64 start = benchNow();
+    f64 elapsed;
+    do {
+      for (u32 i = 0; i < BENCH_MOVES; i++) {
+        rubikMove(&cube, moves[i]);
+      }
+      count  += BENCH_MOVES;
+      elapsed = benchNow() - start;
+    } while (elapsed < BENCH_SECONDS);
+
+    // Replaying inverse moves backwards solves the cube.
+    rubikReset(&cube);
+    for (u32 i = 0; i < BENCH_MOVES; i++) {
+      rubikMove(&cube, moves[i]);
+    }
+    for (u32 i = BENCH_MOVES; i > 0; i--) {
+      rubikMove(&cube, rubikInverse(moves[i - 1]));
+    }
+
+    usize tables = (usize)cube.offsets[3 * size * 3] * 2 * sizeof(u32);
+    printf("  %3ux%-3u %10.3f Mmoves/s, tables %8.2f MB%s\n", size, size,
+        count / elapsed * 1e-6, tables / 1048576.0,
+        rubikSolved(&cube) ? "" : " (MISMATCH)");
+    rubikFree(&cube);
+  }
+
+  gfree(moves);
+
+  Kociemba solver;
+  f64 start   = benchNow();
+  bool loaded = kociembaInit(&solver, BENCH_TABLES);
+  printf("  3x3 solver tables %s in %.3f ms\n", loaded ? "loaded" : "generated",
+      (benchNow() - start) * 1e3);
+
+  RubikCube cube;
+  rubikInit(&cube, 3);
+  u16 values[BENCH_SCRAMBLE];
+  u8 solution[KOCIEMBA_MAX_LENGTH];
+  f64 total   = 0;
+  f64 longest = 0;
+  u32 length  = 0;
+  u32 failed  = 0;
+
+  for (u32 s = 0; s < BENCH_SCRAMBLES; s++) {
+    rubikReset(&cube);
+    randomFill16(s, 0, 0, values, BENCH_SCRAMBLE);
+    for (u32 i = 0; i < BENCH_SCRAMBLE; i++) {
+      rubikMove(&cube, kociembaMove(values[i] % KOCIEMBA_MOVES));
+    }
+
+    start = benchNow();
+    i32 count = kociembaSolve(&solver, &cube, BENCH_SOLUTION, solution);
+    f64 elapsed = benchNow() - start;
+    total  += elapsed;
+    longest = max_value(longest, elapsed);
+
+    for (i32 i = 0; i < count; i++) {
+      rubikMove(&cube, kociembaMove(solution[i]));
+    }
+    if (count < 0 || !rubikSolved(&cube)) {
+      failed++;
+    } else {
+      length += count;
+    }
+  }
+
+  printf("  3x3 solver %8.3f ms/solve, longest %.3f ms, %.2f moves%s\n",
+      total * 1e3 / BENCH_SCRAMBLES, longest * 1e3,
+      (f64)length / max_value(BENCH_SCRAMBLES - failed, 1u),
+      failed == 0 ? "" : " (MISMATCH)");
+
+  rubikFree(&cube);
+  kociembaFree(&solver);
+}
+
+void benchVectors(u32 edge) {
+  u32 count = edge * edge * edge;
+  printf("Vector benchmark: %ux%ux%u lattice, %u vectors\n", edge, edge, edge, count);
+
+  // Lattice of the cubes of the side 1 centered on the origin.
+  Vectors lattice, positions;
+  vectorsInit(&lattice, count);
+  vectorsInit(&positions, count);
+  for (u32 i = 0; i < count; i++) {
+    vectorsSet(&lattice, i, i % edge - edge * 0.5f, i / edge % edge - edge * 0.5f,
+        i / edge / edge - edge * 0.5f);
+  }
+  Vector3* out = gmalloc(count * sizeof(Vector3));
+
+  f32 scale     = 1.5f;
+  f32 offset[3] = { 0.5f * scale, 0.5f * scale, 0.5f * scale };
+
+  // Per-element raymath calls as in the lattice of the cube scene.
+  f64 transform = 0;
+  for (u32 pass = 0; pass < BENCH_PASSES; pass++) {
+    f64 start = benchNow();
+    for (u32 i = 0; i < count; i++) {
+      Vector3 position = { lattice.x[i], lattice.y[i], lattice.z[i] };
+      out[i] = Vector3Scale(Vector3AddValue(position, 0.5f), scale);
+    }
+    transform += benchNow() - start;
+  }
+
+  f64 batch_transform = 0;
+  for (u32 pass = 0; pass < BENCH_PASSES; pass++) {
+    f64 start = benchNow();
+    vectorsTransform(&positions, &lattice, scale, offset);
+    batch_transform += benchNow() - start;
+  }
+
+  // Batch multiplies before adding, so positions may differ by rounding.
+  u32 mismatched = 0;
+  for (u32 i = 0; i < count; i++) {
+    mismatched += fabsf(positions.x[i] - out[i].x) > 1e-4f
+      || fabsf(positions.y[i] - out[i].y) > 1e-4f
+      || fabsf(positions.z[i] - out[i].z) > 1e-4f;
+  }
+
+  f64 scale_ns = 1e9 / ((f64)count * BENCH_PASSES);
+  printf("  transform raymath %6.2f ns/vector, batch %6.2f ns/vector%s\n",
+      transform * scale_ns, batch_transform * scale_ns,
+      mismatched == 0 ? "" : " (MISMATCH)");
+
+  gfree(out);
+  vectorsFree(&positions);
+  vectorsFree(&lattice);
+}
+
+// BenchBitboard is the plain two-state life on the torus with a single bit
+// plane, the baseline of the multi-color life.
+typedef struct {
+  u32 stride;
+  u32 words;
+  u64* alive;
+  u64* next;
+} BenchBitboard;
+
+// benchBitboardShift fills west and east copies of the row.
+local void benchBitboardShift(BenchBitboard* board, const u64* row, u64* west, u64* east) {
+  bitplaneShift(row, board->words, board->stride, west, east);
+}
+
+local void benchBitboardRows(void* ctx, u32 begin, u32 end) {
+  BenchBitboard* board = ctx;
+  u32 words = board->words;
+
+  // Shifted rows are reused by three consecutive rows of the band, the
+  // same way as in the multi-color life.
+  u64* scratch = gmalloc((usize)words * 2 * 3 * sizeof(u64));
+  u64* west[3];
+  u64* east[3];
+  for (u32 r = 0; r < 3; r++) {
+    west[r] = scratch + (r * 2 + 0) * words;
+    east[r] = scratch + (r * 2 + 1) * words;
+  }
+
+  usize first = (usize)modi32((i32)begin - 1, board->stride) * words;
+  benchBitboardShift(board, board->alive + first, west[0], east[0]);
+  benchBitboardShift(board, board->alive + (usize)begin * words, west[1], east[1]);
+
+  for (u32 y = begin; y < end; y++) {
+    const u64* up   = board->alive + (usize)modi32((i32)y - 1, board->stride) * words;
+    const u64* mid  = board->alive + (usize)y * words;
+    const u64* down = board->alive + (usize)modi32((i32)y + 1, board->stride) * words;
+
+    benchBitboardShift(board, down, west[2], east[2]);
+
+    for (u32 i = 0; i < words; i++) {
+      u64 n[8] = {
+        west[0][i], up[i],   east[0][i],
+        west[1][i],          east[1][i],
+        west[2][i], down[i], east[2][i],
+      };
+      u64 s[4];
+      bitplaneCount(n, s);
+
+      // B3/S23: two or three neighbors keep the cell, three give birth.
+      board->next[(usize)y * words + i] = s[1] & ~s[2] & (s[0] | mid[i]);
+    }
+
+    u64* recycled = west[0];
+    west[0] = west[1]; west[1] = west[2]; west[2] = recycled;
+    recycled = east[0];
+    east[0] = east[1]; east[1] = east[2]; east[2] = recycled;
+  }
+
+  gfree(scratch);
+}
+
+void benchColorLife(u32 stride, u32 generations) {
+  printf("Color life benchmark: %ux%u cells, %u generations\n",
+      stride, stride, generations);
+
+  BenchBitboard board = { .stride = stride, .words = bitplaneWords(stride) };
+  usize plane = (usize)board.words * stride;
+  board.alive = gcalloc(plane, sizeof(u64));
+  board.next  = gcalloc(plane, sizeof(u64));
+
+  ColorLife lives[2];
+  u32 species[2] = { 2, 4 };
+  for (u32 l = 0; l < 2; l++) {
+    colorLifeInit(&lives[l], stride, species[l]);
+  }
+
+  // The same soup goes to every field, colors of the cells do not change
+  // which of them are alive.
+  u16 values[BENCH_VIEWPORT];
+  for (u32 y = 0; y < stride; y++) {
+    for (u32 x = 0; x < stride; x += BENCH_VIEWPORT) {
+      u32 count = min_value(stride - x, BENCH_VIEWPORT);
+      randomFill16(1, y, x, values, count);
+      for (u32 i = 0; i < count; i++) {
+        if (values[i] >= 0x10000 * 0.35) {
+          continue;
+        }
+        board.alive[(usize)y * board.words + (x + i) / 64] |= 1ull << ((x + i) % 64);
+        for (u32 l = 0; l < 2; l++) {
+          colorLifeCellSet(&lives[l], x + i, y, 1 + values[i] % species[l]);
+        }
+      }
+    }
+  }
+
+  f64 start = benchNow();
+  for (u32 g = 0; g < generations; g++) {
+    workersRun(stride, benchBitboardRows, &board);
+    u64* tmp = board.alive; board.alive = board.next; board.next = tmp;
+  }
+  f64 bitboard = benchNow() - start;
+  printf("  one-plane life %8.3f ms/gen\n", bitboard * 1e3 / generations);
+
+  const char* names[2] = { "immigration", "quadlife" };
+  for (u32 l = 0; l < 2; l++) {
+    start = benchNow();
+    for (u32 g = 0; g < generations; g++) {
+      colorLifeUpdate(&lives[l]);
+    }
+    f64 elapsed = benchNow() - start;
+
+    bool same = memcmp(lives[l].alive, board.alive, plane * sizeof(u64)) == 0;
+    printf("  %-14s %8.3f ms/gen, %5.2fx of one-plane life%s\n", names[l],
+        elapsed * 1e3 / generations, elapsed / bitboard, same ? "" : " (MISMATCH)");
+    colorLifeFree(&lives[l]);
+  }
+
+  gfree(board.next);
+  gfree(board.alive);
+}
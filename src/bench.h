@@ -0,0 +1,58 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+// Headless benchmarks, they print results to the standard output.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// benchLayout compares row-major and tiled layouts of the field of the
+// given size on the update and on the extraction of the viewport.
+void benchLayout(u32 width, u32 height, u32 generations);
+
+// benchFork forks the tiled field of the given size, edits the fork and
+// reports how many tiles the parent and the fork still share while they
+// advance.
+void benchFork(u32 width, u32 height, u32 generations);
+
+// benchRubik measures table-driven layer moves of the Rubik's cubes from
+// 3x3x3 up to 100x100x100 and the solver of the random 3x3x3 scrambles.
+void benchRubik(void);
+
+// benchVectors compares per-element raymath calls with the batches of the
+// vectors on the lattice with the given number of the cubes along the edge.
+void benchVectors(u32 edge);
+
+// benchColorLife compares Immigration and QuadLife with the plain life on a
+// single bit plane, all of them run on the same soup of the given size.
+void benchColorLife(u32 stride, u32 generations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _BITPLANE_H
+#define _BITPLANE_H
+
+// Helpers for the fields stored as bit planes, 64 cells per word. Rows of
+// the planes wrap around the torus and bits past the end of the row are
+// always zero.
+
+#include "types.h"
+
+#define BITPLANE_WORD_BITS 64
+
+// bitplaneWords returns number of words in the row of given width.
+local inline u32 bitplaneWords(u32 width) {
+  return (width + BITPLANE_WORD_BITS - 1) / BITPLANE_WORD_BITS;
+}
+
+// bitplaneWest returns word i of the row shifted east by one cell, so it
+// holds western neighbors of the cells, wrapping around the torus.
+local inline u64 bitplaneWest(const u64* row, u32 words, u32 width, u32 i) {
+  u32 last = words - 1;
+  u32 tail = (width - 1) % BITPLANE_WORD_BITS;
+
+  u64 carry = i > 0 ? row[i - 1] >> (BITPLANE_WORD_BITS - 1) : (row[last] >> tail) & 1;
+  u64 word  = (row[i] << 1) | carry;
+  if (i == last && tail != BITPLANE_WORD_BITS - 1) {
+    word &= (1ull << (tail + 1)) - 1;
+  }
+  return word;
+}
+
+// bitplaneEast returns word i of the row holding eastern neighbors.
+local inline u64 bitplaneEast(const u64* row, u32 words, u32 width, u32 i) {
+  u32 last = words - 1;
+  u32 tail = (width - 1) % BITPLANE_WORD_BITS;
+
+  u64 carry = i < last ? (row[i + 1] & 1) << (BITPLANE_WORD_BITS - 1) : 0;
+  u64 word  = (row[i] >> 1) | carry;
+  if (i == last) {
+    word |= (row[0] & 1) << tail;
+  }
+  return word;
+}
+
+// bitplaneShift fills west and east copies of the whole row, words inside
+// of the row need no wrapping, so only the first and the last are fixed.
+local inline void bitplaneShift(const u64* row, u32 words, u32 width, u64* west, u64* east) {
+  for (u32 i = 1; i + 1 < words; i++) {
+    west[i] = (row[i] << 1) | (row[i - 1] >> (BITPLANE_WORD_BITS - 1));
+    east[i] = (row[i] >> 1) | (row[i + 1] << (BITPLANE_WORD_BITS - 1));
+  }
+  west[0] = bitplaneWest(row, words, width, 0);
+  east[0] = bitplaneEast(row, words, width, 0);
+  west[words - 1] = bitplaneWest(row, words, width, words - 1);
+  east[words - 1] = bitplaneEast(row, words, width, words - 1);
+}
+
+// Full and half adders over bit planes, words may be vectors as well.
+#define FULL_ADD(a, b, c, s, cy) do { \
+  __typeof__((a) ^ (b)) t_ = (a) ^ (b); \
+  (s)  = t_ ^ (c);                      \
+  (cy) = ((a) & (b)) | (t_ & (c));      \
+} while (0)
+
+#define HALF_ADD(a, b, s, cy) do { \
+  (s)  = (a) ^ (b);                \
+  (cy) = (a) & (b);                \
+} while (0)
+
+// bitplaneCount computes bits of the number of set inputs out of eight,
+// s[k] holds bit of the weight 2^k.
+local inline void bitplaneCount(const u64* x, u64 s[4]) {
+  u64 sa, ca, sb, cb, sc, cc, cd, t, ce, cf;
+  FULL_ADD(x[0], x[1], x[2], sa, ca);
+  FULL_ADD(x[3], x[4], x[5], sb, cb);
+  HALF_ADD(x[6], x[7], sc, cc);
+  FULL_ADD(sa, sb, sc, s[0], cd);
+  FULL_ADD(ca, cb, cc, t, ce);
+  HALF_ADD(t, cd, s[1], cf);
+  s[2] = ce ^ cf;
+  s[3] = ce & cf;
+}
+
+// bitplaneMatch returns mask of the cells whose number of neighbors is set
+// in the rule mask, s holds bits of the counts from the bitplaneCount.
+local inline u64 bitplaneMatch(const u64 s[4], u32 mask) {
+  u64 result = 0;
+  for (u32 n = 0; n <= 8; n++) {
+    if ((mask >> n) & 1) {
+      u64 match = ~0ull;
+      for (u32 k = 0; k < 4; k++) {
+        match &= ((n >> k) & 1) ? s[k] : ~s[k];
+      }
+      result |= match;
+    }
+  }
+  return result;
+}
+
+// bitplaneSpread returns word with byte i set to bit i of the bits.
+local inline u64 bitplaneSpread(u8 bits) {
+  // Copies of the seven low bits do not overlap, so multiplication never
+  // carries into the result bytes.
+  u64 low = ((u64)(bits & 0x7f) * 0x0002040810204081ull) & 0x0101010101010101ull;
+  return low | ((u64)(bits >> 7) << 56);
+}
+
+#endif
@@ -0,0 +1,328 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "colorlife.h"
+
+#include "bitplane.h"
+#include "debug.h"
+#include "simd.h"
+#include "workers.h"
+
+void colorLifeInit(ColorLife* life, u32 stride, u32 species) {
+  assertf(species == 2 || species == 4, "Unsupported number of species %u", species);
+
+  u32 words  = bitplaneWords(stride);
+  usize size = (usize)words * stride;
+
+  life->stride     = stride;
+  life->words      = words;
+  life->species    = species;
+  life->generation = 0;
+
+  life->alive      = gcalloc(size, sizeof(u64));
+  life->next_alive = gcalloc(size, sizeof(u64));
+  for (u32 p = 0; p < 2; p++) {
+    life->color[p]      = gcalloc(size, sizeof(u64));
+    life->next_color[p] = gcalloc(size, sizeof(u64));
+  }
+}
+
+void colorLifeFree(ColorLife* life) {
+  gfree(life->alive);
+  gfree(life->next_alive);
+  for (u32 p = 0; p < 2; p++) {
+    gfree(life->color[p]);
+    gfree(life->next_color[p]);
+  }
+}
+
+u32 colorLifeCell(ColorLife* life, i32 x, i32 y) {
+  x = modi32(x, life->stride);
+  y = modi32(y, life->stride);
+
+  usize word = (usize)y * life->words + x / BITPLANE_WORD_BITS;
+  u64 bit    = 1ull << (x % BITPLANE_WORD_BITS);
+
+  if ((life->alive[word] & bit) == 0) {
+    return 0;
+  }
+
+  u32 color = 0;
+  for (u32 p = 0; p < 2; p++) {
+    color |= ((life->color[p][word] & bit) != 0) << p;
+  }
+  return color + 1;
+}
+
+void colorLifeCellSet(ColorLife* life, i32 x, i32 y, u32 cell) {
+  x = modi32(x, life->stride);
+  y = modi32(y, life->stride);
+
+  usize word = (usize)y * life->words + x / BITPLANE_WORD_BITS;
+  u64 bit    = 1ull << (x % BITPLANE_WORD_BITS);
+
+  life->alive[word] &= ~bit;
+  for (u32 p = 0; p < 2; p++) {
+    life->color[p][word] &= ~bit;
+  }
+
+  if (cell == 0) {
+    return;
+  }
+
+  u32 color = (cell - 1) % life->species;
+  life->alive[word] |= bit;
+  for (u32 p = 0; p < 2; p++) {
+    if ((color >> p) & 1) {
+      life->color[p][word] |= bit;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Word-parallel update
+////////////////////////////////////////////////////////////////////////////////
+
+// Span holds what the update needs from the pair of words of the field row,
+// pairs are updated at once in 128-bit vectors. Alive plane is kept as is
+// and shifted by one cell, so that west holds western neighbors of the
+// cells and east holds eastern ones.
+//
+// Colors only matter for the newborn cells, which have exactly three live
+// cells around and none in the center, so every count of colors over the
+// 3x3 block is at most three. Color planes are therefore kept already
+// summed over the cell and its two horizontal neighbors, and the update
+// only adds three rows of the sums.
+typedef struct {
+  u64x2 west;
+  u64x2 center;
+  u64x2 east;
+  // Bits of the sums of the color planes.
+  u64x2 ones[2];
+  u64x2 twos[2];
+  // Parity of the sum of the cells of the color 3.
+  u64x2 odd3;
+} Span;
+
+// colorLifeSpan fills the span from the plane words, index 0 is the alive
+// plane and the rest are the color planes.
+local inline void colorLifeSpan(Span* span, const u64x2* west, const u64x2* center,
+    const u64x2* east, u32 planes) {
+  span->west   = west[0];
+  span->center = center[0];
+  span->east   = east[0];
+  for (u32 p = 1; p < planes; p++) {
+    FULL_ADD(west[p], center[p], east[p], span->ones[p - 1], span->twos[p - 1]);
+  }
+  if (planes == 3) {
+    span->odd3 = (west[1] & west[2]) ^ (center[1] & center[2]) ^ (east[1] & east[2]);
+  }
+}
+
+// colorLifeShiftPair fills the span of the pair j. Inner pairs are shifted
+// directly, edges of the row wrap around and the last pair may have one
+// word.
+local inline void colorLifeShiftPair(ColorLife* life, const u64** sources, Span* out,
+    u32 j, u32 planes, bool inner) {
+  u32 words = life->words;
+  u32 width = life->stride;
+  u32 i     = j * 2;
+
+  u64x2 west[3], center[3], east[3];
+  for (u32 p = 0; p < planes; p++) {
+    const u64* source = sources[p];
+    if (inner) {
+      center[p] = u64x2Load(source + i);
+      west[p]   = (center[p] << 1) | (u64x2Load(source + i - 1) >> (BITPLANE_WORD_BITS - 1));
+      east[p]   = (center[p] >> 1) | (u64x2Load(source + i + 1) << (BITPLANE_WORD_BITS - 1));
+      continue;
+    }
+    for (u32 k = 0; k < 2; k++) {
+      bool inside  = i + k < words;
+      center[p][k] = inside ? source[i + k] : 0;
+      west[p][k]   = inside ? bitplaneWest(source, words, width, i + k) : 0;
+      east[p][k]   = inside ? bitplaneEast(source, words, width, i + k) : 0;
+    }
+  }
+  colorLifeSpan(out + (usize)j * 3, west, center, east, planes);
+}
+
+// colorLifeShift fills spans of the field row. Spans of the row are three
+// apart, so that rows of the ring of three are interleaved and the update
+// reads all of them through three pointers.
+local inline void colorLifeShift(ColorLife* life, Span* out, usize row, u32 planes) {
+  const u64* sources[3] = { life->alive + row, life->color[0] + row, life->color[1] + row };
+  u32 pairs = (life->words + 1) / 2;
+  // Pairs after the first one and before this one are inside of the row.
+  u32 inner = (life->words - 1) / 2;
+
+  colorLifeShiftPair(life, sources, out, 0, planes, false);
+  for (u32 j = 1; j < inner; j++) {
+    colorLifeShiftPair(life, sources, out, j, planes, true);
+  }
+  for (u32 j = max_value(inner, 1); j < pairs; j++) {
+    colorLifeShiftPair(life, sources, out, j, planes, false);
+  }
+}
+
+// colorLifeLife computes survivors and newborn cells of the pair.
+local inline void colorLifeLife(const Span* up, const Span* mid, const Span* down,
+    u64x2* survival, u64x2* birth) {
+  u64x2 sa, ca, sb, cb, sc, cc, s0, cd, t, ce, s1, cf;
+  FULL_ADD(up->west, up->center, up->east, sa, ca);
+  FULL_ADD(mid->west, mid->east, down->west, sb, cb);
+  HALF_ADD(down->center, down->east, sc, cc);
+  FULL_ADD(sa, sb, sc, s0, cd);
+  FULL_ADD(ca, cb, cc, t, ce);
+  HALF_ADD(t, cd, s1, cf);
+
+  // Count is 2 or 3 when its second bit is set and the higher ones are not.
+  u64x2 two = s1 & ~(ce | cf);
+  *survival = mid->center & two;
+  *birth    = ~mid->center & s0 & two;
+}
+
+// colorLifeColors adds three rows of sums of the color plane. Result is
+// exact only for the newborn cells.
+local inline void colorLifeColors(const Span* up, const Span* mid, const Span* down,
+    u32 p, u64x2* ones, u64x2* twos) {
+  u64x2 a = up->ones[p], b = mid->ones[p], c = down->ones[p];
+  *ones = a ^ b ^ c;
+  *twos = up->twos[p] | mid->twos[p] | down->twos[p] | (a & b) | (c & (a ^ b));
+}
+
+// colorLifeLoad reads the pair from the row, the last pair may have one
+// word.
+local inline u64x2 colorLifeLoad(const u64* row, u32 words, u32 i) {
+  return i + 1 < words ? u64x2Load(row + i) : (u64x2){ row[i], 0 };
+}
+
+// colorLifeStore writes the pair into the row.
+local inline void colorLifeStore(u64* row, u32 words, u32 i, u64x2 value) {
+  if (i + 1 < words) {
+    u64x2Store(row + i, value);
+  } else {
+    row[i] = value[0];
+  }
+}
+
+// colorLifeRowTwo updates the row of Immigration. Every newborn cell has
+// exactly three parents, so its color is the majority of their colors,
+// that is at least two parents of the color 1.
+local void colorLifeRowTwo(ColorLife* life, const Span* up, const Span* mid,
+    const Span* down, usize row) {
+  u32 words = life->words;
+
+  for (u32 i = 0; i < words; i += 2, up += 3, mid += 3, down += 3) {
+    u64x2 survival, birth, ones, twos;
+    colorLifeLife(up, mid, down, &survival, &birth);
+    colorLifeColors(up, mid, down, 0, &ones, &twos);
+
+    u64x2 color = colorLifeLoad(life->color[0] + row, words, i);
+    colorLifeStore(life->next_alive + row, words, i, survival | birth);
+    colorLifeStore(life->next_color[0] + row, words, i, (survival & color) | (birth & twos));
+  }
+}
+
+// colorLifeRowFour updates the row of QuadLife. Per-plane majority of the
+// three parents gives the majority color when it exists. Otherwise all of
+// the parents are different, the missing color is their xor, and every
+// plane of it is the minority bit of the parents, so the majority is
+// inverted.
+//
+// Parents are all different only when both plane counts are 1 or 2, and
+// then the number of parents of the color 3 tells the cases apart: counts
+// 1 and 1 are {0, 1, 2} without them or {0, 0, 3} with one, the other
+// counts are distinct with one parent of the color 3 and repeat a color
+// with none or two. So its parity is enough.
+local void colorLifeRowFour(ColorLife* life, const Span* up, const Span* mid,
+    const Span* down, usize row) {
+  u32 words = life->words;
+
+  for (u32 i = 0; i < words; i += 2, up += 3, mid += 3, down += 3) {
+    u64x2 survival, birth, ones0, twos0, ones1, twos1;
+    colorLifeLife(up, mid, down, &survival, &birth);
+    colorLifeColors(up, mid, down, 0, &ones0, &twos0);
+    colorLifeColors(up, mid, down, 1, &ones1, &twos1);
+
+    u64x2 odd3     = up->odd3 ^ mid->odd3 ^ down->odd3;
+    u64x2 middle   = (ones0 ^ twos0) & (ones1 ^ twos1);
+    u64x2 distinct = middle & (odd3 ^ ~(twos0 | twos1));
+
+    u64x2 color0 = colorLifeLoad(life->color[0] + row, words, i);
+    u64x2 color1 = colorLifeLoad(life->color[1] + row, words, i);
+    colorLifeStore(life->next_alive + row, words, i, survival | birth);
+    colorLifeStore(life->next_color[0] + row, words, i, (survival & color0) | (birth & (twos0 ^ distinct)));
+    colorLifeStore(life->next_color[1] + row, words, i, (survival & color1) | (birth & (twos1 ^ distinct)));
+  }
+}
+
+// colorLifeBand updates the band of rows. Spans of the rows above, at and
+// below the updated one are kept in the ring of three, so every row of the
+// planes is shifted and summed once and reused by three rows of the band.
+// Pair j of the ring row r is at j * 3 + r.
+local inline void colorLifeBand(ColorLife* life, u32 begin, u32 end, u32 planes) {
+  u32 words = life->words;
+  Span* ring = gmalloc((usize)(words + 1) / 2 * 3 * sizeof(Span));
+
+  colorLifeShift(life, ring, (usize)modi32((i32)begin - 1, life->stride) * words, planes);
+  colorLifeShift(life, ring + 1, (usize)begin * words, planes);
+
+  // Ring index of the row below the updated one.
+  u32 down = 2;
+  for (u32 y = begin; y < end; y++) {
+    colorLifeShift(life, ring + down, (usize)modi32((i32)y + 1, life->stride) * words, planes);
+
+    // Rows above and at the updated one precede the row below in the ring.
+    const Span* up  = ring + (down + 1) % 3;
+    const Span* mid = ring + (down + 2) % 3;
+    if (planes == 3) {
+      colorLifeRowFour(life, up, mid, ring + down, (usize)y * words);
+    } else {
+      colorLifeRowTwo(life, up, mid, ring + down, (usize)y * words);
+    }
+    down = (down + 1) % 3;
+  }
+
+  gfree(ring);
+}
+
+local void colorLifeRows(void* ctx, u32 begin, u32 end) {
+  ColorLife* life = ctx;
+  // Number of planes is constant in each of the calls, so the shifts are
+  // unrolled for it.
+  if (life->species == 4) {
+    colorLifeBand(life, begin, end, 3);
+  } else {
+    colorLifeBand(life, begin, end, 2);
+  }
+}
+
+void colorLifeUpdate(ColorLife* life) {
+  workersRun(life->stride, colorLifeRows, life);
+
+  u64* tmp;
+  tmp = life->alive; life->alive = life->next_alive; life->next_alive = tmp;
+  for (u32 p = 0; p < 2; p++) {
+    tmp = life->color[p]; life->color[p] = life->next_color[p]; life->next_color[p] = tmp;
+  }
+  life->generation++;
+}
@@ -0,0 +1,79 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _COLORLIFE_H
+#define _COLORLIFE_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COLOR_LIFE_MAX_SPECIES 4
+
+// ColorLife is a multi-color variant of the game of life on the torus:
+// Immigration with two species and QuadLife with four. Live cells survive
+// with their color, newborn cells take the color of the majority of their
+// three parents, or the missing color when all parents are different.
+//
+// Cells are stored as bit planes, 64 cells per word, so the whole update
+// is computed with word-parallel logic.
+typedef struct {
+  // Size of the side of the field
+  u32 stride;
+  // Number of words in a single row of the plane
+  u32 words;
+  // Number of species, either 2 or 4
+  u32 species;
+
+  // Plane of live cells.
+  u64* alive;
+  // Bits of the color index, only set for the live cells. Second plane is
+  // used only by four species.
+  u64* color[2];
+
+  // Planes for the next generation.
+  u64* next_alive;
+  u64* next_color[2];
+
+  // Number of generations since the start.
+  u64 generation;
+} ColorLife;
+
+void colorLifeInit(ColorLife* life, u32 stride, u32 species);
+void colorLifeFree(ColorLife* life);
+
+// colorLifeCell returns 0 for the empty cell and color index + 1 for the
+// live one, coordinates are wrapped.
+u32 colorLifeCell(ColorLife* life, i32 x, i32 y);
+
+// colorLifeCellSet sets cell to the value in format of colorLifeCell.
+void colorLifeCellSet(ColorLife* life, i32 x, i32 y, u32 cell);
+
+// colorLifeUpdate advances field by single generation.
+void colorLifeUpdate(ColorLife* life);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
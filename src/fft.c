@@ -0,0 +1,259 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "fft.h"
+
+#include <math.h>
+
+#include "debug.h"
+#include "workers.h"
+
+void fftPlanInit(FFTPlan* plan, u32 size) {
+  assertf(size > 0 && (size & (size - 1)) == 0,
+      "FFT size %u is not a power of two", size);
+
+  plan->size     = size;
+  plan->reverse  = gmalloc(size * sizeof(*plan->reverse));
+  plan->twiddles = gmalloc(max_value(size / 2, 1) * sizeof(*plan->twiddles));
+
+  u32 bits = 0;
+  while ((1u << bits) < size) bits++;
+
+  for (u32 i = 0; i < size; i++) {
+    u32 r = 0;
+    for (u32 b = 0; b < bits; b++) {
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    }
+    plan->reverse[i] = r;
+  }
+
+  for (u32 k = 0; k < size / 2; k++) {
+    f64 angle = -2.0 * M_PI * k / size;
+    plan->twiddles[k] = (Complex){ .re = cos(angle), .im = sin(angle) };
+  }
+}
+
+void fftPlanFree(FFTPlan* plan) {
+  gfree(plan->reverse);
+  gfree(plan->twiddles);
+}
+
+local void fftTransform(FFTPlan* plan, Complex* data, bool inverse) {
+  u32 n = plan->size;
+
+  for (u32 i = 0; i < n; i++) {
+    u32 r = plan->reverse[i];
+    if (i < r) {
+      Complex tmp = data[i];
+      data[i] = data[r];
+      data[r] = tmp;
+    }
+  }
+
+  f32 sign = inverse ? -1.0f : 1.0f;
+
+  for (u32 len = 2; len <= n; len <<= 1) {
+    u32 half = len >> 1;
+    u32 step = n / len;
+    for (u32 i = 0; i < n; i += len) {
+      Complex* a = data + i;
+      Complex* b = data + i + half;
+      for (u32 k = 0; k < half; k++) {
+        Complex w = plan->twiddles[k * step];
+        f32 wi = sign * w.im;
+        f32 re = b[k].re * w.re - b[k].im * wi;
+        f32 im = b[k].re * wi   + b[k].im * w.re;
+        b[k].re = a[k].re - re;
+        b[k].im = a[k].im - im;
+        a[k].re += re;
+        a[k].im += im;
+      }
+    }
+  }
+}
+
+void fftForward(FFTPlan* plan, Complex* data) {
+  fftTransform(plan, data, false);
+}
+
+void fftInverse(FFTPlan* plan, Complex* data) {
+  fftTransform(plan, data, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// 2D real transform
+////////////////////////////////////////////////////////////////////////////////
+
+void fft2dInit(FFT2D* fft, u32 width, u32 height) {
+  assertf(width >= 4, "FFT width %u is too small", width);
+
+  fft->width  = width;
+  fft->height = height;
+  fftPlanInit(&fft->rows, width / 2);
+  fftPlanInit(&fft->cols, height);
+
+  u32 count = fft2dSpectrumWidth(fft);
+  fft->split = gmalloc(count * sizeof(*fft->split));
+  for (u32 k = 0; k < count; k++) {
+    f64 angle = -2.0 * M_PI * k / width;
+    fft->split[k] = (Complex){ .re = cos(angle), .im = sin(angle) };
+  }
+}
+
+void fft2dFree(FFT2D* fft) {
+  fftPlanFree(&fft->rows);
+  fftPlanFree(&fft->cols);
+  gfree(fft->split);
+}
+
+typedef struct {
+  FFT2D*     fft;
+  const f32* image;
+  f32*       output;
+  Complex*   spectrum;
+} FFT2DJob;
+
+// Real row of width n is transformed as complex row of n/2 values
+// z[k] = x[2k] + i*x[2k+1], then even and odd parts are separated:
+//   X[k] = E[k] + W^k * O[k]
+//   E[k] = (Z[k] + conj(Z[n/2 - k])) / 2
+//   O[k] = (Z[k] - conj(Z[n/2 - k])) / 2i
+local void fft2dForwardRows(void* ctx, u32 begin, u32 end) {
+  FFT2DJob* job = ctx;
+  FFT2D* fft    = job->fft;
+  u32 half      = fft->width / 2;
+  u32 count     = fft2dSpectrumWidth(fft);
+
+  for (u32 y = begin; y < end; y++) {
+    Complex* row = job->spectrum + (usize)y * count;
+    // Packed row fits into the first half of the spectrum row.
+    memcpy(row, job->image + (usize)y * fft->width, fft->width * sizeof(f32));
+    fftForward(&fft->rows, row);
+
+    Complex z0 = row[0];
+    row[0]    = (Complex){ .re = z0.re + z0.im, .im = 0 };
+    row[half] = (Complex){ .re = z0.re - z0.im, .im = 0 };
+
+    for (u32 k = 1; k <= half / 2; k++) {
+      u32 j = half - k;
+      Complex a = row[k];
+      Complex b = row[j];
+
+      // Pair (k, j) is computed at once, so rows are updated in place.
+      Complex ek = { .re = 0.5f * (a.re + b.re), .im = 0.5f * (a.im - b.im) };
+      Complex ok = { .re = 0.5f * (a.im + b.im), .im = 0.5f * (b.re - a.re) };
+      Complex ej = { .re = ek.re, .im = -ek.im };
+      Complex oj = { .re = ok.re, .im = -ok.im };
+
+      Complex wk = fft->split[k];
+      Complex wj = fft->split[j];
+
+      row[k].re = ek.re + wk.re * ok.re - wk.im * ok.im;
+      row[k].im = ek.im + wk.re * ok.im + wk.im * ok.re;
+      row[j].re = ej.re + wj.re * oj.re - wj.im * oj.im;
+      row[j].im = ej.im + wj.re * oj.im + wj.im * oj.re;
+    }
+  }
+}
+
+local void fft2dInverseRows(void* ctx, u32 begin, u32 end) {
+  FFT2DJob* job = ctx;
+  FFT2D* fft    = job->fft;
+  u32 half      = fft->width / 2;
+  u32 count     = fft2dSpectrumWidth(fft);
+
+  for (u32 y = begin; y < end; y++) {
+    Complex* row = job->spectrum + (usize)y * count;
+
+    // Z[k] = E[k] + i*O[k], where
+    //   E[k] = X[k] + conj(X[n/2 - k])
+    //   O[k] = (X[k] - conj(X[n/2 - k])) * conj(W^k)
+    Complex x0 = row[0];
+    Complex xh = row[half];
+    row[0] = (Complex){ .re = x0.re + xh.re, .im = x0.re - xh.re };
+
+    for (u32 k = 1; k <= half / 2; k++) {
+      u32 j = half - k;
+      Complex a = row[k];
+      Complex b = row[j];
+
+      Complex ek = { .re = a.re + b.re, .im = a.im - b.im };
+      Complex dk = { .re = a.re - b.re, .im = a.im + b.im };
+      Complex ej = { .re = ek.re, .im = -ek.im };
+      Complex dj = { .re = -dk.re, .im = dk.im };
+
+      Complex wk = fft->split[k];
+      Complex wj = fft->split[j];
+      Complex ok = {
+        .re = dk.re * wk.re + dk.im * wk.im,
+        .im = dk.im * wk.re - dk.re * wk.im,
+      };
+      Complex oj = {
+        .re = dj.re * wj.re + dj.im * wj.im,
+        .im = dj.im * wj.re - dj.re * wj.im,
+      };
+
+      row[k] = (Complex){ .re = ek.re - ok.im, .im = ek.im + ok.re };
+      row[j] = (Complex){ .re = ej.re - oj.im, .im = ej.im + oj.re };
+    }
+
+    fftInverse(&fft->rows, row);
+    memcpy(job->output + (usize)y * fft->width, row, fft->width * sizeof(f32));
+  }
+}
+
+local void fft2dColumns(void* ctx, u32 begin, u32 end, bool inverse) {
+  FFT2DJob* job = ctx;
+  FFT2D* fft    = job->fft;
+  u32 count     = fft2dSpectrumWidth(fft);
+
+  Complex* column = gmalloc(fft->height * sizeof(*column));
+  for (u32 x = begin; x < end; x++) {
+    for (u32 y = 0; y < fft->height; y++) {
+      column[y] = job->spectrum[(usize)y * count + x];
+    }
+    fftTransform(&fft->cols, column, inverse);
+    for (u32 y = 0; y < fft->height; y++) {
+      job->spectrum[(usize)y * count + x] = column[y];
+    }
+  }
+  gfree(column);
+}
+
+local void fft2dForwardColumns(void* ctx, u32 begin, u32 end) {
+  fft2dColumns(ctx, begin, end, false);
+}
+
+local void fft2dInverseColumns(void* ctx, u32 begin, u32 end) {
+  fft2dColumns(ctx, begin, end, true);
+}
+
+void fft2dForward(FFT2D* fft, const f32* image, Complex* spectrum) {
+  FFT2DJob job = { .fft = fft, .image = image, .spectrum = spectrum };
+  workersRun(fft->height, fft2dForwardRows, &job);
+  workersRun(fft2dSpectrumWidth(fft), fft2dForwardColumns, &job);
+}
+
+void fft2dInverse(FFT2D* fft, Complex* spectrum, f32* image) {
+  FFT2DJob job = { .fft = fft, .output = image, .spectrum = spectrum };
+  workersRun(fft2dSpectrumWidth(fft), fft2dInverseColumns, &job);
+  workersRun(fft->height, fft2dInverseRows, &job);
+}
@@ -0,0 +1,89 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _FFT_H
+#define _FFT_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  f32 re;
+  f32 im;
+} Complex;
+
+// FFTPlan holds precomputed tables for the radix-2 complex transform of
+// the fixed size.
+typedef struct {
+  // Size of the transform, must be a power of two.
+  u32 size;
+  // Bit reversal permutation.
+  u32* reverse;
+  // exp(-2*pi*i*k/size) for k in [0, size/2).
+  Complex* twiddles;
+} FFTPlan;
+
+void fftPlanInit(FFTPlan* plan, u32 size);
+void fftPlanFree(FFTPlan* plan);
+
+// fftForward performs in-place unnormalized forward transform.
+void fftForward(FFTPlan* plan, Complex* data);
+
+// fftInverse performs in-place unnormalized inverse transform, so
+// fftInverse(fftForward(x)) == size * x.
+void fftInverse(FFTPlan* plan, Complex* data);
+
+// FFT2D transforms real image of width x height into the half spectrum of
+// height x (width / 2 + 1) complex values. Rows and columns are processed
+// in parallel by the shared workers.
+typedef struct {
+  u32 width;
+  u32 height;
+  // Complex transform of half of the row for the packed real transform.
+  FFTPlan rows;
+  // Complex transform of the spectrum columns.
+  FFTPlan cols;
+  // exp(-2*pi*i*k/width) for k in [0, width/2], used to split packed
+  // real transform.
+  Complex* split;
+} FFT2D;
+
+// fft2dSpectrumWidth returns number of complex values in the spectrum row.
+#define fft2dSpectrumWidth(fft) ((fft)->width / 2 + 1)
+
+void fft2dInit(FFT2D* fft, u32 width, u32 height);
+void fft2dFree(FFT2D* fft);
+
+// fft2dForward computes half spectrum of the real image.
+void fft2dForward(FFT2D* fft, const f32* image, Complex* spectrum);
+
+// fft2dInverse restores real image from the half spectrum, result is scaled
+// by width * height. Spectrum is used as scratch space and destroyed.
+void fft2dInverse(FFT2D* fft, Complex* spectrum, f32* image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
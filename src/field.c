@@ -0,0 +1,519 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "field.h"
+
+#include <stdlib.h>
+
+#include "debug.h"
+#include "random.h"
+#include "workers.h"
+
+void fieldInit(Field* field, u32 width, u32 height) {
+  u32 pitch  = (width + FIELD_ALIGN - 1) / FIELD_ALIGN * FIELD_ALIGN;
+  usize size = (usize)pitch * height;
+
+  field->current = (u8*)aligned_alloc(FIELD_ALIGN, size);
+  field->next    = (u8*)aligned_alloc(FIELD_ALIGN, size);
+  memset(field->current, EMPTY, size);
+  memset(field->next, EMPTY, size);
+  field->changed = gcalloc(height, sizeof(u8));
+
+  field->width  = width;
+  field->height = height;
+  field->pitch  = pitch;
+
+  field->generation         = 0;
+  field->seed               = 0;
+  field->birth_threshold    = FIELD_CERTAIN;
+  field->survival_threshold = FIELD_CERTAIN;
+
+  field->neighborhood = NEIGHBORHOOD_MOORE;
+  field->mask         = 0;
+  field->rule         = RULE_LIFE;
+  field->topology     = TOPOLOGY_TORUS;
+}
+
+void fieldSetProbabilities(Field* field, f64 birth, f64 survival, u64 seed) {
+  field->seed               = seed;
+  field->birth_threshold    = max_value(0, min_value(1, birth)) * FIELD_CERTAIN;
+  field->survival_threshold = max_value(0, min_value(1, survival)) * FIELD_CERTAIN;
+}
+
+// fieldIsStochastic checks if any of the rules is probabilistic.
+local bool fieldIsStochastic(Field* field) {
+  return field->birth_threshold < FIELD_CERTAIN
+    || field->survival_threshold < FIELD_CERTAIN;
+}
+
+bool ruleParse(const char* text, u32 population, Rule* rule) {
+  Rule result = { 0 };
+  u32* current = NULL;
+  // Counts of the section are separated by commas when any of them has more
+  // than one digit, e.g. "B3,10/S2,3,12", otherwise every digit is a count.
+  bool separated = false;
+
+  for (const char* c = text; *c != '\0'; c++) {
+    if (*c == 'B' || *c == 'b' || *c == 'S' || *c == 's') {
+      current   = (*c == 'B' || *c == 'b') ? &result.birth : &result.survival;
+      separated = strcspn(c + 1, "/BbSs") > strcspn(c + 1, ",");
+    } else if (*c >= '0' && *c <= '9' && current != NULL) {
+      u32 count = *c - '0';
+      if (separated) {
+        char* end;
+        count = strtoul(c, &end, 10);
+        c     = end - 1;
+      }
+      if (count > population) {
+        return false;
+      }
+      *current |= 1u << count;
+    } else if (*c == ',' && separated) {
+      continue;
+    } else if (*c != '/') {
+      return false;
+    }
+  }
+
+  *rule = result;
+  return true;
+}
+
+u32 neighborhoodPopulation(Neighborhood neighborhood, u32 mask) {
+  switch (neighborhood) {
+    case NEIGHBORHOOD_VON_NEUMANN:
+      return 4;
+    case NEIGHBORHOOD_HEX:
+      return 6;
+    case NEIGHBORHOOD_CUSTOM:
+      return __builtin_popcount(mask);
+    default:
+      return 8;
+  }
+}
+
+Rule ruleDefault(Neighborhood neighborhood) {
+  switch (neighborhood) {
+    case NEIGHBORHOOD_VON_NEUMANN:
+      // B1/S1, grows Sierpinski-like patterns from a single cell.
+      return (Rule){ .birth = 1 << 1, .survival = 1 << 1 };
+    case NEIGHBORHOOD_HEX:
+      // B2/S34, hexagonal life with gliders.
+      return (Rule){ .birth = 1 << 2, .survival = (1 << 3) | (1 << 4) };
+    default:
+      return RULE_LIFE;
+  }
+}
+
+bool neighborhoodParse(const char* text, Neighborhood* neighborhood, u32* mask) {
+  *mask = 0;
+  if (strcmp(text, "moore") == 0) {
+    *neighborhood = NEIGHBORHOOD_MOORE;
+  } else if (strcmp(text, "von-neumann") == 0) {
+    *neighborhood = NEIGHBORHOOD_VON_NEUMANN;
+  } else if (strcmp(text, "hex") == 0) {
+    *neighborhood = NEIGHBORHOOD_HEX;
+  } else if (strncmp(text, "custom:", 7) == 0) {
+    char* end;
+    *neighborhood = NEIGHBORHOOD_CUSTOM;
+    // Center of the square is never a neighbor.
+    *mask = strtoul(text + 7, &end, 0) & ~(1u << 12) & ((1u << 25) - 1);
+    return *end == '\0';
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void fieldSetNeighborhood(Field* field, Neighborhood neighborhood, u32 mask, Rule rule) {
+  assertf(neighborhood != NEIGHBORHOOD_HEX || (field->height & 1) == 0,
+      "Hexagonal neighborhood requires even height, got %u", field->height);
+
+  field->neighborhood = neighborhood;
+  field->mask         = mask;
+  field->rule         = rule;
+}
+
+bool topologyParse(const char* text, Topology* topology) {
+  local const char* names[] = {
+    [TOPOLOGY_TORUS]         = "torus",
+    [TOPOLOGY_BOUNDED]       = "bounded",
+    [TOPOLOGY_CYLINDER]      = "cylinder",
+    [TOPOLOGY_KLEIN_BOTTLE]  = "klein",
+    [TOPOLOGY_CROSS_SURFACE] = "cross-surface",
+  };
+
+  for (usize i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (strcmp(text, names[i]) == 0) {
+      *topology = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+u32 fieldNeighbors(Field* field, i32 y, i32 offsets[MAX_NEIGHBORS][2]) {
+  local const i32 moore[][2] = {
+    { -1, -1 }, { 0, -1 }, { 1, -1 },
+    { -1,  0 },            { 1,  0 },
+    { -1,  1 }, { 0,  1 }, { 1,  1 },
+  };
+  local const i32 von_neumann[][2] = {
+    { 0, -1 }, { -1, 0 }, { 1, 0 }, { 0, 1 },
+  };
+  local const i32 hex_even[][2] = {
+    { -1, -1 }, { 0, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 },
+  };
+  local const i32 hex_odd[][2] = {
+    { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 },
+  };
+
+  const i32 (*table)[2] = moore;
+  u32 count = 8;
+
+  switch (field->neighborhood) {
+    case NEIGHBORHOOD_MOORE:
+      break;
+    case NEIGHBORHOOD_VON_NEUMANN:
+      table = von_neumann;
+      count = 4;
+      break;
+    case NEIGHBORHOOD_HEX:
+      table = (y & 1) ? hex_odd : hex_even;
+      count = 6;
+      break;
+    case NEIGHBORHOOD_CUSTOM:
+      count = 0;
+      for (i32 bit = 0; bit < 25; bit++) {
+        if ((field->mask >> bit) & 1) {
+          offsets[count][0] = bit % 5 - 2;
+          offsets[count][1] = bit / 5 - 2;
+          count++;
+        }
+      }
+      return count;
+  }
+
+  memcpy(offsets, table, count * sizeof(table[0]));
+  return count;
+}
+
+typedef struct {
+  Field* field;
+  u32 threshold;
+  u64 seed;
+} FieldSoupJob;
+
+// fieldSoupRows fills rows in range [begin, end) with random cells.
+local void fieldSoupRows(void* ctx, u32 begin, u32 end) {
+  FieldSoupJob* job = ctx;
+  Field* field = job->field;
+
+  // Cells are numbered without the padding, so the soup does not depend on
+  // the pitch.
+  for (u32 y = begin; y < end; y++) {
+    randomFillThreshold(job->seed, RANDOM_STREAM_SOUP, (u64)y * field->width,
+        job->threshold, ALIVE, EMPTY, field->current + (usize)y * field->pitch,
+        field->width);
+  }
+}
+
+void fieldRandomize(Field* field, f64 density, u64 seed) {
+  FieldSoupJob job = {
+    .field     = field,
+    .threshold = max_value(0, min_value(1, density)) * FIELD_CERTAIN,
+    .seed      = seed,
+  };
+  workersRun(field->height, fieldSoupRows, &job);
+}
+
+void fieldFree(Field* field) {
+  free(field->current);
+  free(field->next);
+  gfree(field->changed);
+}
+
+bool fieldCellWrap(Field* field, i32* x, i32* y) {
+  i32 width  = field->width;
+  i32 height = field->height;
+  bool outside_x = *x < 0 || *x >= width;
+  bool outside_y = *y < 0 || *y >= height;
+
+  switch (field->topology) {
+    case TOPOLOGY_TORUS:
+      break;
+    case TOPOLOGY_BOUNDED:
+      return !outside_x && !outside_y;
+    case TOPOLOGY_CYLINDER:
+      if (outside_y) {
+        return false;
+      }
+      break;
+    case TOPOLOGY_KLEIN_BOTTLE:
+      // Crossing top or bottom edge mirrors the column.
+      if (outside_y) {
+        *x = width - 1 - *x;
+      }
+      break;
+    case TOPOLOGY_CROSS_SURFACE:
+      // Crossing any edge mirrors the other coordinate.
+      if (outside_y) {
+        *x = width - 1 - *x;
+      }
+      if (outside_x) {
+        *y = height - 1 - *y;
+      }
+      break;
+  }
+
+  *x = modi32(*x, width);
+  *y = modi32(*y, height);
+  return true;
+}
+
+usize fieldCellIndex(Field* field, i32 x, i32 y) {
+  bool inside = fieldCellWrap(field, &x, &y);
+  assertf(inside, "Cell (%d, %d) is outside of the bounded field", x, y);
+
+  usize idx = (usize)field->pitch * y + x;
+  usize len = (usize)field->pitch * field->height;
+
+  assertf(idx < len, "Index %zu is out of bounds (length: %zu)", idx, len);
+
+  return idx;
+}
+
+void fieldCellSet(Field* field, i32 x, i32 y, State state) {
+  // Cells outside of the bounded field are ignored, just like they read as
+  // empty in fieldCellState.
+  if (!fieldCellWrap(field, &x, &y)) {
+    return;
+  }
+  usize idx = fieldCellIndex(field, x, y);
+  field->current[idx] = state;
+}
+
+State fieldCellState(Field* field, i32 x, i32 y) {
+  if (!fieldCellWrap(field, &x, &y)) {
+    return EMPTY;
+  }
+  usize idx = fieldCellIndex(field, x, y);
+  return field->current[idx];
+}
+
+bool fieldCellIsAlive(Field* field, i32 x, i32 y) {
+  return fieldCellState(field, x, y) == ALIVE;
+}
+
+
+// fieldNext returns state of the cell at the next game tick, chance is the
+// random value drawn for the cell by the stochastic rules.
+local inline State fieldNext(Field* field, u8 state, u32 alive_neighbors, u16 chance) {
+  bool alive = state == ALIVE;
+  bool birth = !alive && ((field->rule.birth >> alive_neighbors) & 1)
+    && chance < field->birth_threshold;
+  bool survival = alive && ((field->rule.survival >> alive_neighbors) & 1)
+    && chance < field->survival_threshold;
+  return birth || survival ? ALIVE : fieldFade(state);
+}
+
+// FieldRow holds rows around the updated one, so the kernels never compute
+// cell indices.
+typedef struct {
+  const u8* nn;
+  const u8* n;
+  const u8* c;
+  const u8* s;
+  const u8* ss;
+  u8* next;
+  const u16* chances;
+} FieldRow;
+
+#define ALIVE_AT(row, col) ((row)[col] == ALIVE)
+
+// Neighbor counts, columns ww, w, x, e and ee are 2 cells west, 1 cell
+// west, current, 1 cell east and 2 cells east.
+#define COUNT_MOORE(r)                                                    \
+  (ALIVE_AT(r->n, w) + ALIVE_AT(r->n, x) + ALIVE_AT(r->n, e) +            \
+   ALIVE_AT(r->c, w) +                     ALIVE_AT(r->c, e) +            \
+   ALIVE_AT(r->s, w) + ALIVE_AT(r->s, x) + ALIVE_AT(r->s, e))
+
+#define COUNT_VON_NEUMANN(r)                                              \
+  (ALIVE_AT(r->n, x) + ALIVE_AT(r->c, w) + ALIVE_AT(r->c, e) +            \
+   ALIVE_AT(r->s, x))
+
+// Even rows are not shifted, so their neighbors above and below are
+// shifted to the west.
+#define COUNT_HEX_EVEN(r)                                                 \
+  (ALIVE_AT(r->n, w) + ALIVE_AT(r->n, x) +                                \
+   ALIVE_AT(r->c, w) + ALIVE_AT(r->c, e) +                                \
+   ALIVE_AT(r->s, w) + ALIVE_AT(r->s, x))
+
+#define COUNT_HEX_ODD(r)                                                  \
+  (ALIVE_AT(r->n, x) + ALIVE_AT(r->n, e) +                                \
+   ALIVE_AT(r->c, w) + ALIVE_AT(r->c, e) +                                \
+   ALIVE_AT(r->s, x) + ALIVE_AT(r->s, e))
+
+#define MASKED_AT(row, col, bit) (ALIVE_AT(row, col) & ((mask >> (bit)) & 1))
+
+#define COUNT_CUSTOM(r)                                                   \
+  (MASKED_AT(r->nn, ww,  0) + MASKED_AT(r->nn, w,  1) +                   \
+   MASKED_AT(r->nn, x,   2) + MASKED_AT(r->nn, e,  3) +                   \
+   MASKED_AT(r->nn, ee,  4) +                                             \
+   MASKED_AT(r->n,  ww,  5) + MASKED_AT(r->n,  w,  6) +                   \
+   MASKED_AT(r->n,  x,   7) + MASKED_AT(r->n,  e,  8) +                   \
+   MASKED_AT(r->n,  ee,  9) +                                             \
+   MASKED_AT(r->c,  ww, 10) + MASKED_AT(r->c,  w, 11) +                   \
+   MASKED_AT(r->c,  e,  13) + MASKED_AT(r->c,  ee, 14) +                  \
+   MASKED_AT(r->s,  ww, 15) + MASKED_AT(r->s,  w, 16) +                   \
+   MASKED_AT(r->s,  x,  17) + MASKED_AT(r->s,  e, 18) +                   \
+   MASKED_AT(r->s,  ee, 19) +                                             \
+   MASKED_AT(r->ss, ww, 20) + MASKED_AT(r->ss, w, 21) +                   \
+   MASKED_AT(r->ss, x,  22) + MASKED_AT(r->ss, e, 23) +                   \
+   MASKED_AT(r->ss, ee, 24))
+
+#define FIELD_CELL(COUNT, r, west2, west, east, east2)                     \
+  do {                                                                    \
+    i32 ww = west2, w = west, e = east, ee = east2;                       \
+    (void)ww;                                                             \
+    (void)ee;                                                             \
+    r->next[x] = fieldNext(field, r->c[x], COUNT(r), r->chances[x]);      \
+  } while (0)
+
+// FIELD_KERNEL defines update of the columns in range [begin, end) of the
+// interior row, where all neighbors are inside of the field and do not
+// depend on the topology.
+#define FIELD_KERNEL(name, COUNT)                                         \
+  local void name(Field* field, FieldRow* r, i32 begin, i32 end) {        \
+    u32 mask = field->mask;                                               \
+    (void)mask;                                                           \
+                                                                          \
+    for (i32 x = begin; x < end; x++) {                                   \
+      FIELD_CELL(COUNT, r, x - 2, x - 1, x + 1, x + 2);                   \
+    }                                                                     \
+  }
+
+FIELD_KERNEL(fieldKernelMoore,      COUNT_MOORE)
+FIELD_KERNEL(fieldKernelVonNeumann, COUNT_VON_NEUMANN)
+FIELD_KERNEL(fieldKernelHexEven,    COUNT_HEX_EVEN)
+FIELD_KERNEL(fieldKernelHexOdd,     COUNT_HEX_ODD)
+FIELD_KERNEL(fieldKernelCustom,     COUNT_CUSTOM)
+
+// Number of rows and columns on each side of the field that may have
+// neighbors on the other side of the edge.
+#define FIELD_EDGE 2
+
+// fieldEdgeCells computes next state of the cells in range [begin, end) of
+// the row y, whose neighbors are looked up through the topology.
+local void fieldEdgeCells(Field* field, FieldRow* r, i32 y, i32 begin, i32 end) {
+  i32 offsets[MAX_NEIGHBORS][2];
+  u32 count = fieldNeighbors(field, y, offsets);
+
+  for (i32 x = begin; x < end; x++) {
+    u32 alive = 0;
+    for (u32 i = 0; i < count; i++) {
+      i32 nx = x + offsets[i][0];
+      i32 ny = y + offsets[i][1];
+      if (fieldCellWrap(field, &nx, &ny)) {
+        alive += field->current[(usize)ny * field->pitch + nx] == ALIVE;
+      }
+    }
+    r->next[x] = fieldNext(field, r->c[x], alive, r->chances[x]);
+  }
+}
+
+// fieldRowChanged reports whether any cell of the row was born or died.
+local bool fieldRowChanged(const u8* current, const u8* next, u32 width) {
+  u8 changed = 0;
+  for (u32 x = 0; x < width; x++) {
+    changed |= (current[x] == ALIVE) ^ (next[x] == ALIVE);
+  }
+  return changed != 0;
+}
+
+// fieldUpdateRows computes next state of the rows in range [begin, end).
+local void fieldUpdateRows(void* ctx, u32 begin, u32 end) {
+  Field* field = ctx;
+  i32 width    = field->width;
+  i32 height   = field->height;
+  i32 pitch    = field->pitch;
+
+  bool stochastic = fieldIsStochastic(field);
+  u16* chances = gcalloc(field->width, sizeof(u16));
+
+  for (i32 y = begin; y < (i32)end; y++) {
+    if (stochastic) {
+      randomFill16(field->seed, field->generation, (u64)y * field->width,
+          chances, field->width);
+    }
+
+    FieldRow row = {
+      .c       = field->current + (usize)y * pitch,
+      .next    = field->next + (usize)y * pitch,
+      .chances = chances,
+    };
+
+    if (y < FIELD_EDGE || y >= height - FIELD_EDGE || width <= 2 * FIELD_EDGE) {
+      fieldEdgeCells(field, &row, y, 0, width);
+      field->changed[y] = fieldRowChanged(row.c, row.next, width);
+      continue;
+    }
+
+    row.nn = row.c - 2 * pitch;
+    row.n  = row.c - pitch;
+    row.s  = row.c + pitch;
+    row.ss = row.c + 2 * pitch;
+
+    fieldEdgeCells(field, &row, y, 0, FIELD_EDGE);
+    switch (field->neighborhood) {
+      case NEIGHBORHOOD_MOORE:
+        fieldKernelMoore(field, &row, FIELD_EDGE, width - FIELD_EDGE);
+        break;
+      case NEIGHBORHOOD_VON_NEUMANN:
+        fieldKernelVonNeumann(field, &row, FIELD_EDGE, width - FIELD_EDGE);
+        break;
+      case NEIGHBORHOOD_HEX:
+        if (y & 1) {
+          fieldKernelHexOdd(field, &row, FIELD_EDGE, width - FIELD_EDGE);
+        } else {
+          fieldKernelHexEven(field, &row, FIELD_EDGE, width - FIELD_EDGE);
+        }
+        break;
+      case NEIGHBORHOOD_CUSTOM:
+        fieldKernelCustom(field, &row, FIELD_EDGE, width - FIELD_EDGE);
+        break;
+    }
+    fieldEdgeCells(field, &row, y, width - FIELD_EDGE, width);
+    field->changed[y] = fieldRowChanged(row.c, row.next, width);
+  }
+
+  gfree(chances);
+}
+
+void fieldUpdate(Field* field) {
+  workersRun(field->height, fieldUpdateRows, field);
+  field->generation++;
+
+  usize size = (usize)field->pitch * field->height;
+
+  // Updating current state of the field
+  memcpy(field->current, field->next, size);
+}
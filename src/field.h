@@ -0,0 +1,197 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _FIELD_H
+#define _FIELD_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  EMPTY  = 0,
+  DEAD   = 2,
+  DIYING = 3,
+  ALIVE  = 4,
+} State;
+
+// fieldFade returns state of the cell that is not alive at the next tick:
+// ALIVE fades into DIYING, DIYING into DEAD, DEAD and EMPTY stay.
+local inline State fieldFade(u8 state) {
+  return state >= DIYING ? state - 1 : state;
+}
+
+// Threshold value that makes birth or survival unconditional.
+#define FIELD_CERTAIN 0x10000
+
+// Neighborhood selects cells that are counted as neighbors. Every
+// neighborhood has its own update kernel with fully unrolled counting.
+typedef enum {
+  // Eight surrounding cells.
+  NEIGHBORHOOD_MOORE       = 0,
+  // Four orthogonally adjacent cells.
+  NEIGHBORHOOD_VON_NEUMANN = 1,
+  // Six cells of the hexagonal grid, where odd rows are shifted by half of
+  // the cell to the right.
+  NEIGHBORHOOD_HEX         = 2,
+  // Cells of the 5x5 square around the cell selected by the mask, bit
+  // (dy + 2) * 5 + (dx + 2) selects cell at offset (dx, dy).
+  NEIGHBORHOOD_CUSTOM      = 3,
+} Neighborhood;
+
+// Topology selects how the edges of the field are glued together.
+typedef enum {
+  // Opposite edges are glued.
+  TOPOLOGY_TORUS         = 0,
+  // Cells outside of the field are always empty.
+  TOPOLOGY_BOUNDED       = 1,
+  // Left and right edges are glued, top and bottom are bounded.
+  TOPOLOGY_CYLINDER      = 2,
+  // Left and right edges are glued, top and bottom are glued with a twist.
+  TOPOLOGY_KLEIN_BOTTLE  = 3,
+  // Both pairs of edges are glued with a twist.
+  TOPOLOGY_CROSS_SURFACE = 4,
+} Topology;
+
+// Maximum number of neighbors in any of the neighborhoods.
+#define MAX_NEIGHBORS 24
+
+// Rule of the life-like automaton, bit n of the mask is set when the cell
+// with n live neighbors is born or survives.
+typedef struct {
+  u32 birth;
+  u32 survival;
+} Rule;
+
+// Conway's game of life: B3/S23.
+#define RULE_LIFE ((Rule){ .birth = 1 << 3, .survival = (1 << 2) | (1 << 3) })
+
+// Rows of the field are padded to the multiple of the alignment, so every
+// row starts at the cache line.
+#define FIELD_ALIGN 64
+
+// Field represents playing field.
+typedef struct {
+  // Size of the field in cells.
+  u32 width;
+  u32 height;
+  // Distance in bytes between the starts of the consecutive rows, padding
+  // cells are always empty.
+  u32 pitch;
+  // Current state of the field
+  u8* current;
+  // Temporary array that holds state of the cells for the next game tick.
+  u8* next;
+  // Flags of the rows where any cell was born or died in the last update.
+  u8* changed;
+
+  // Number of game ticks since the start.
+  u64 generation;
+  // Seed of the random stream used by the stochastic rules.
+  u64 seed;
+  // Birth and survival happen only when random 16-bit value drawn for the
+  // cell is less than threshold, so FIELD_CERTAIN gives the classic rules.
+  u32 birth_threshold;
+  u32 survival_threshold;
+
+  // Neighborhood and rule of the automaton.
+  Neighborhood neighborhood;
+  u32 mask;
+  Rule rule;
+  // Topology of the field used by fieldUpdate.
+  Topology topology;
+} Field;
+
+// ruleParse parses rule in the B/S notation, e.g. "B3/S23". Counts above
+// single digit are separated by commas, e.g. "B3,10/S2,3,12", counts above
+// the population of the neighborhood are rejected.
+bool ruleParse(const char* text, u32 population, Rule* rule);
+
+// neighborhoodPopulation returns number of neighbors of the cell.
+u32 neighborhoodPopulation(Neighborhood neighborhood, u32 mask);
+
+// ruleDefault returns well known rule for the neighborhood.
+Rule ruleDefault(Neighborhood neighborhood);
+
+// neighborhoodParse parses neighborhood name: "moore", "von-neumann", "hex"
+// or "custom:MASK", where MASK is a number in format of the strtoul.
+bool neighborhoodParse(const char* text, Neighborhood* neighborhood, u32* mask);
+
+// fieldInit initializes empty field of the given size.
+void fieldInit(Field* field, u32 width, u32 height);
+
+// fieldSetProbabilities makes births and survivals happen with given
+// probabilities. Random values are keyed by seed, generation and cell index,
+// so the outcome does not depend on number of threads.
+void fieldSetProbabilities(Field* field, f64 birth, f64 survival, u64 seed);
+
+// topologyParse parses topology name: "torus", "bounded", "cylinder",
+// "klein" or "cross-surface".
+bool topologyParse(const char* text, Topology* topology);
+
+// fieldSetNeighborhood changes neighborhood and rule of the field.
+// NOTE: hexagonal neighborhood requires even height for rows to tile the
+//  torus.
+void fieldSetNeighborhood(Field* field, Neighborhood neighborhood, u32 mask, Rule rule);
+
+// fieldNeighbors writes offsets of the neighbors of the cell in the row y
+// and returns number of the neighbors.
+u32 fieldNeighbors(Field* field, i32 y, i32 offsets[MAX_NEIGHBORS][2]);
+
+// fieldRandomize fills field with live cells with given density, the rest
+// of the cells are empty. Every cell depends only on the seed and its
+// position, so result is the same for any number of threads.
+void fieldRandomize(Field* field, f64 density, u64 seed);
+
+// fieldFree frees resouces allocated by the field.
+void fieldFree(Field* field);
+
+// fieldCellWrap maps coordinates of the cell outside of the field onto the
+// field according to its topology. Returns false when the cell is outside
+// of the bounded edge, such cells are always empty.
+bool fieldCellWrap(Field* field, i32* x, i32* y);
+
+// fieldCellIndex returns index of the cell in the array, the cell must be
+// inside of the field after wrapping.
+usize fieldCellIndex(Field* field, i32 x, i32 y);
+
+// fieldCellSet sets cell state, cells outside of the bounded field are
+// ignored.
+void fieldCellSet(Field* field, i32 x, i32 y, State state);
+
+// fieldCellState returns cell state, cells outside of the bounded edges
+// are empty.
+State fieldCellState(Field* field, i32 x, i32 y);
+
+// fieldCellIsAlive checks if the cell at given coordinates is alive.
+bool fieldCellIsAlive(Field* field, i32 x, i32 y);
+
+// fieldUpdate updates current state of the field and flags the rows where
+// any cell was born or died.
+void fieldUpdate(Field* field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
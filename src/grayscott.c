@@ -0,0 +1,181 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "grayscott.h"
+
+#include "debug.h"
+#include "simd.h"
+#include "workers.h"
+
+// Width of the column block processed for all rows of the band before
+// moving to the next one, so rows of the stencil stay in L1 cache even on
+// very wide fields.
+#ifndef GRAY_SCOTT_BLOCK
+#define GRAY_SCOTT_BLOCK 1024
+#endif
+
+// Weights of the 9-point laplacian.
+#define LAPLACE_CENTER   -1.0f
+#define LAPLACE_ADJACENT  0.2f
+#define LAPLACE_DIAGONAL  0.05f
+
+local u32 grayScottWrap(i32 a, u32 stride) {
+  if (a < 0) return a + stride;
+  if ((u32)a >= stride) return a - stride;
+  return a;
+}
+
+local u32 grayScottMod(i32 a, u32 stride) {
+  i32 r = a % (i32)stride;
+  return (u32)(r < 0 ? r + (i32)stride : r);
+}
+
+void grayScottInit(GrayScott* gs, u32 stride, GrayScottParams params) {
+  assertf(stride >= 4, "Field stride %u is too small", stride);
+
+  usize size = (usize)stride * stride;
+
+  gs->stride = stride;
+  gs->params = params;
+  gs->u      = gmalloc(size * sizeof(f32));
+  gs->v      = gcalloc(size, sizeof(f32));
+  gs->next_u = gmalloc(size * sizeof(f32));
+  gs->next_v = gmalloc(size * sizeof(f32));
+
+  for (usize i = 0; i < size; i++) {
+    gs->u[i] = 1.0f;
+  }
+}
+
+void grayScottFree(GrayScott* gs) {
+  gfree(gs->u);
+  gfree(gs->v);
+  gfree(gs->next_u);
+  gfree(gs->next_v);
+}
+
+void grayScottSeed(GrayScott* gs, i32 x, i32 y, u32 size) {
+  i32 half = size / 2;
+  for (i32 dy = -half; dy < half; dy++) {
+    for (i32 dx = -half; dx < half; dx++) {
+      u32 cx = grayScottMod(x + dx, gs->stride);
+      u32 cy = grayScottMod(y + dy, gs->stride);
+      usize idx = (usize)cy * gs->stride + cx;
+      gs->u[idx] = 0.5f;
+      gs->v[idx] = 0.25f;
+    }
+  }
+}
+
+typedef struct {
+  const f32* restrict n;
+  const f32* restrict c;
+  const f32* restrict s;
+} Rows;
+
+local f32 grayScottLaplaceAt(Rows r, u32 x, u32 w, u32 e) {
+  return LAPLACE_CENTER * r.c[x]
+       + LAPLACE_ADJACENT * (r.n[x] + r.s[x] + r.c[w] + r.c[e])
+       + LAPLACE_DIAGONAL * (r.n[w] + r.n[e] + r.s[w] + r.s[e]);
+}
+
+local inline f32x4 grayScottLaplace(Rows r, u32 x) {
+  f32x4 adjacent = f32x4Load(r.n + x) + f32x4Load(r.s + x)
+                 + f32x4Load(r.c + x - 1) + f32x4Load(r.c + x + 1);
+  f32x4 diagonal = f32x4Load(r.n + x - 1) + f32x4Load(r.n + x + 1)
+                 + f32x4Load(r.s + x - 1) + f32x4Load(r.s + x + 1);
+  return f32x4Load(r.c + x) * LAPLACE_CENTER
+       + adjacent * LAPLACE_ADJACENT
+       + diagonal * LAPLACE_DIAGONAL;
+}
+
+// grayScottCell updates single cell, used for columns that wrap around.
+local void grayScottCell(GrayScott* gs, Rows ru, Rows rv, usize row, u32 x) {
+  GrayScottParams p = gs->params;
+  u32 w = grayScottWrap((i32)x - 1, gs->stride);
+  u32 e = grayScottWrap((i32)x + 1, gs->stride);
+
+  f32 u   = ru.c[x];
+  f32 v   = rv.c[x];
+  f32 uvv = u * v * v;
+
+  gs->next_u[row + x] = u + p.dt * (p.du * grayScottLaplaceAt(ru, x, w, e) - uvv + p.feed * (1.0f - u));
+  gs->next_v[row + x] = v + p.dt * (p.dv * grayScottLaplaceAt(rv, x, w, e) + uvv - (p.feed + p.kill) * v);
+}
+
+// grayScottSpan updates cells of the row y in columns [from, to).
+local void grayScottSpan(GrayScott* gs, u32 y, u32 from, u32 to) {
+  u32 stride = gs->stride;
+  usize row  = (usize)y * stride;
+  usize up   = (usize)grayScottWrap((i32)y - 1, stride) * stride;
+  usize down = (usize)grayScottWrap((i32)y + 1, stride) * stride;
+
+  Rows ru = { .n = gs->u + up, .c = gs->u + row, .s = gs->u + down };
+  Rows rv = { .n = gs->v + up, .c = gs->v + row, .s = gs->v + down };
+
+  GrayScottParams p = gs->params;
+
+  f32* restrict next_u = gs->next_u + row;
+  f32* restrict next_v = gs->next_v + row;
+
+  u32 x = from;
+  if (x == 0) {
+    grayScottCell(gs, ru, rv, row, x++);
+  }
+
+  // Last vector must not read past the last column.
+  for (; x + F32X4_LANES < stride && x + F32X4_LANES <= to; x += F32X4_LANES) {
+    f32x4 u   = f32x4Load(ru.c + x);
+    f32x4 v   = f32x4Load(rv.c + x);
+    f32x4 uvv = u * v * v;
+
+    f32x4 nu = u + p.dt * (p.du * grayScottLaplace(ru, x) - uvv + p.feed * (1.0f - u));
+    f32x4 nv = v + p.dt * (p.dv * grayScottLaplace(rv, x) + uvv - (p.feed + p.kill) * v);
+
+    f32x4Store(next_u + x, nu);
+    f32x4Store(next_v + x, nv);
+  }
+
+  for (; x < to; x++) {
+    grayScottCell(gs, ru, rv, row, x);
+  }
+}
+
+local void grayScottRows(void* ctx, u32 begin, u32 end) {
+  GrayScott* gs = ctx;
+
+  for (u32 from = 0; from < gs->stride; from += GRAY_SCOTT_BLOCK) {
+    u32 to = min_value(from + GRAY_SCOTT_BLOCK, gs->stride);
+    for (u32 y = begin; y < end; y++) {
+      grayScottSpan(gs, y, from, to);
+    }
+  }
+}
+
+void grayScottUpdate(GrayScott* gs) {
+  for (u32 i = 0; i < gs->params.substeps; i++) {
+    workersRun(gs->stride, grayScottRows, gs);
+
+    f32* tmp;
+    tmp = gs->u; gs->u = gs->next_u; gs->next_u = tmp;
+    tmp = gs->v; gs->v = gs->next_v; gs->next_v = tmp;
+  }
+}
@@ -0,0 +1,82 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _GRAYSCOTT_H
+#define _GRAYSCOTT_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// GrayScottParams describes two species reaction-diffusion system:
+//   u' = u + dt * (du * L(u) - u*v*v + feed * (1 - u))
+//   v' = v + dt * (dv * L(v) + u*v*v - (feed + kill) * v)
+// where L is a 9-point laplacian.
+typedef struct {
+  f32 du;
+  f32 dv;
+  f32 feed;
+  f32 kill;
+  f32 dt;
+  // Number of integration steps per single update.
+  u32 substeps;
+} GrayScottParams;
+
+// Parameters that produce "mitosis" pattern.
+#define GRAY_SCOTT_MITOSIS ((GrayScottParams){ \
+  .du       = 1.0f,                            \
+  .dv       = 0.5f,                            \
+  .feed     = 0.0367f,                         \
+  .kill     = 0.0649f,                         \
+  .dt       = 1.0f,                            \
+  .substeps = 8,                               \
+})
+
+// GrayScott holds concentrations of both species on the torus.
+typedef struct {
+  // Size of the side of the field
+  u32 stride;
+  GrayScottParams params;
+
+  // Current concentrations
+  f32* u;
+  f32* v;
+  // Concentrations at the next step
+  f32* next_u;
+  f32* next_v;
+} GrayScott;
+
+void grayScottInit(GrayScott* gs, u32 stride, GrayScottParams params);
+void grayScottFree(GrayScott* gs);
+
+// grayScottSeed disturbs square of the given size around (x, y).
+void grayScottSeed(GrayScott* gs, i32 x, i32 y, u32 size);
+
+// grayScottUpdate advances system by params.substeps integration steps.
+void grayScottUpdate(GrayScott* gs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,906 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "hashlife.h"
+
+#include <string.h>
+
+#include "debug.h"
+#include "workers.h"
+
+// Memory of the single node including its share of the hash table, the
+// table has at most two buckets per node.
+#define HASHLIFE_NODE_BYTES    (sizeof(HashLifeNode) + 2 * sizeof(u32))
+// Pool grows by chunks of 2^HASHLIFE_CHUNK_BITS nodes.
+#define HASHLIFE_CHUNK_BITS    16
+#define HASHLIFE_CHUNK         (1u << HASHLIFE_CHUNK_BITS)
+// Capacity of the stack of the nodes used by the computation.
+#define HASHLIFE_STACK         16384
+// Level of the collected nodes.
+#define HASHLIFE_FREE          0xFF
+// Nodes of this level and above are split into subnodes for the workers.
+#define HASHLIFE_PARALLEL_LEVEL 8
+// Parallel step waits for this many nodes per thread before computing
+// them.
+#define HASHLIFE_WAVE_PER_THREAD 4
+
+// hashlifeNode returns node of the pool.
+local inline HashLifeNode* hashlifeNode(HashLife* life, u32 id) {
+  return &life->chunks[id >> HASHLIFE_CHUNK_BITS][id & (HASHLIFE_CHUNK - 1)];
+}
+
+// hashlifeHash mixes indices of the quadrants.
+local u32 hashlifeHash(u32 nw, u32 ne, u32 sw, u32 se) {
+  u64 hash = nw;
+  hash = hash * 0x9E3779B97F4A7C15ull + ne;
+  hash = hash * 0x9E3779B97F4A7C15ull + sw;
+  hash = hash * 0x9E3779B97F4A7C15ull + se;
+  return (hash ^ (hash >> 32)) * 0x85EBCA6Bu;
+}
+
+// hashlifeTableInit computes center cells of all 4x4 blocks, bit y * 4 + x
+// of the block is cell (x, y), bit y * 2 + x of the result is cell
+// (x + 1, y + 1).
+local void hashlifeTableInit(HashLife* life) {
+  for (u32 block = 0; block < 1 << 16; block++) {
+    u8 result = 0;
+    for (u32 y = 1; y < 3; y++) {
+      for (u32 x = 1; x < 3; x++) {
+        u32 count = 0;
+        for (u32 dy = y - 1; dy <= y + 1; dy++) {
+          for (u32 dx = x - 1; dx <= x + 1; dx++) {
+            count += (block >> (dy * 4 + dx)) & 1;
+          }
+        }
+        bool alive = (block >> (y * 4 + x)) & 1;
+        count -= alive;
+        u32 mask = alive ? life->rule.survival : life->rule.birth;
+        result |= ((mask >> count) & 1) << ((y - 1) * 2 + (x - 1));
+      }
+    }
+    life->table[block] = result;
+  }
+}
+
+// hashlifeKeep protects node from the collection until the stack of the
+// thread is unwound by the caller.
+local u32 hashlifeKeep(HashLifeThread* thread, u32 id) {
+  assertf(thread->stack_count < HASHLIFE_STACK, "Hashlife stack overflow");
+  thread->stack[thread->stack_count++] = id;
+  return id;
+}
+
+// hashlifeResultOf returns cached result of the node, results are written
+// by the threads without locks.
+local inline u32 hashlifeResultOf(HashLifeNode* node) {
+  return __atomic_load_n(&node->result, __ATOMIC_ACQUIRE);
+}
+
+// hashlifeMark marks node and nodes reachable from it, results are
+// followed when requested.
+local void hashlifeMark(HashLife* life, u32 id, bool results) {
+  if (id == HASHLIFE_NONE) {
+    return;
+  }
+
+  HashLifeNode* node = hashlifeNode(life, id);
+  if (node->marked) {
+    return;
+  }
+  node->marked = 1;
+  if (node->level == 0) {
+    return;
+  }
+
+  hashlifeMark(life, node->nw, results);
+  hashlifeMark(life, node->ne, results);
+  hashlifeMark(life, node->sw, results);
+  hashlifeMark(life, node->se, results);
+  if (results) {
+    hashlifeMark(life, node->result, results);
+  }
+}
+
+// hashlifeSweep releases unmarked nodes and clears marks of the rest.
+local void hashlifeSweep(HashLife* life) {
+  for (u32 bucket = 0; bucket <= life->bucket_mask; bucket++) {
+    u32* link = &life->buckets[bucket];
+    while (*link != 0) {
+      u32 id = *link;
+      HashLifeNode* node = hashlifeNode(life, id);
+      if (node->marked) {
+        link = &node->next;
+        continue;
+      }
+      *link        = node->next;
+      node->level  = HASHLIFE_FREE;
+      node->result = HASHLIFE_NONE;
+      node->next   = life->free;
+      life->free   = id;
+      life->count--;
+    }
+  }
+
+  for (u32 id = 0; id < life->used; id++) {
+    hashlifeNode(life, id)->marked = 0;
+  }
+}
+
+// hashlifeMarkRoots marks nodes that must survive the collection.
+local void hashlifeMarkRoots(HashLife* life, bool results) {
+  hashlifeMark(life, 0, results);
+  hashlifeMark(life, 1, results);
+  hashlifeMark(life, life->root, results);
+  for (u32 i = 0; i < HASHLIFE_HISTORY; i++) {
+    hashlifeMark(life, life->history[i], results);
+  }
+  for (u32 level = 0; level <= HASHLIFE_MAX_LEVEL; level++) {
+    hashlifeMark(life, life->empty[level], results);
+  }
+  for (u32 i = 0; i < life->thread_count; i++) {
+    HashLifeThread* thread = &life->threads[i];
+    for (u32 j = 0; j < thread->stack_count; j++) {
+      hashlifeMark(life, thread->stack[j], results);
+    }
+  }
+}
+
+// hashlifeClearResults drops all cached results.
+local void hashlifeClearResults(HashLife* life) {
+  for (u32 id = 0; id < life->used; id++) {
+    hashlifeNode(life, id)->result = HASHLIFE_NONE;
+  }
+}
+
+void hashlifeCollect(HashLife* life) {
+  u32 before = life->count;
+
+  // Cached results are kept first, when they hold most of the pool they
+  // are dropped and the nodes are collected again.
+  hashlifeMarkRoots(life, true);
+  hashlifeSweep(life);
+  if (life->count > life->limit / 4 * 3) {
+    hashlifeClearResults(life);
+    hashlifeMarkRoots(life, false);
+    hashlifeSweep(life);
+  }
+
+  life->stats.collections++;
+  life->stats.reclaimed_bytes += (u64)(before - life->count) * HASHLIFE_NODE_BYTES;
+  life->stats.bytes = (usize)life->count * HASHLIFE_NODE_BYTES;
+}
+
+// hashlifeEnter registers worker thread in the parallel step, it waits
+// for the collection in progress.
+local void hashlifeEnter(HashLife* life) {
+  pthread_mutex_lock(&life->collect_lock);
+  life->active++;
+  pthread_mutex_unlock(&life->collect_lock);
+}
+
+// hashlifeCollectParked collects nodes for the parked threads and wakes
+// them up, collect lock must be held.
+local void hashlifeCollectParked(HashLife* life) {
+  u32 count = life->count;
+  hashlifeCollect(life);
+  life->collect_released = count - life->count;
+  life->waiting = 0;
+  life->collect_epoch++;
+  pthread_cond_broadcast(&life->collected);
+}
+
+// hashlifeLeave unregisters worker thread, when the rest of the threads
+// are parked it collects for them.
+local void hashlifeLeave(HashLife* life) {
+  pthread_mutex_lock(&life->collect_lock);
+  life->active--;
+  if (life->waiting > 0 && life->waiting == life->active) {
+    hashlifeCollectParked(life);
+  }
+  pthread_mutex_unlock(&life->collect_lock);
+}
+
+// hashlifePressure frees space in the full pool and returns number of the
+// released nodes. During the parallel step thread parks, nodes are
+// collected once all active threads are parked, so none of them touches
+// the table or holds unprotected nodes.
+local u32 hashlifePressure(HashLife* life) {
+  if (!life->parallel) {
+    u32 count = life->count;
+    hashlifeCollect(life);
+    return count - life->count;
+  }
+
+  pthread_mutex_lock(&life->collect_lock);
+  life->waiting++;
+  if (life->waiting == life->active) {
+    hashlifeCollectParked(life);
+  } else {
+    u64 epoch = life->collect_epoch;
+    while (epoch == life->collect_epoch) {
+      pthread_cond_wait(&life->collected, &life->collect_lock);
+    }
+  }
+  u32 released = life->collect_released;
+  pthread_mutex_unlock(&life->collect_lock);
+  return released;
+}
+
+// hashlifeAlloc returns unused node, the pool grows up to the limit and
+// then it is collected. Other threads of the parallel step may take the
+// released nodes first, so collections repeat while they release any.
+local u32 hashlifeAlloc(HashLife* life) {
+  for (;;) {
+    if (life->parallel) {
+      pthread_mutex_lock(&life->alloc_lock);
+    }
+
+    if (life->free == HASHLIFE_NONE && life->used == life->capacity
+        && life->capacity < life->limit) {
+      life->chunks[life->capacity >> HASHLIFE_CHUNK_BITS] =
+        gmalloc(HASHLIFE_CHUNK * sizeof(HashLifeNode));
+      life->capacity = min_value((u64)life->capacity + HASHLIFE_CHUNK, life->limit);
+    }
+
+    u32 id = HASHLIFE_NONE;
+    if (life->free != HASHLIFE_NONE) {
+      id = life->free;
+      life->free = hashlifeNode(life, id)->next;
+    } else if (life->used < life->capacity) {
+      id = life->used++;
+    }
+
+    if (id != HASHLIFE_NONE) {
+      life->count++;
+      life->stats.bytes      = (usize)life->count * HASHLIFE_NODE_BYTES;
+      life->stats.peak_bytes = max_value(life->stats.peak_bytes, life->stats.bytes);
+    }
+
+    if (life->parallel) {
+      pthread_mutex_unlock(&life->alloc_lock);
+    }
+    if (id != HASHLIFE_NONE) {
+      return id;
+    }
+
+    u32 released = hashlifePressure(life);
+    assertf(released > 0,
+        "Hashlife memory limit of %u nodes is exceeded by the live nodes", life->limit);
+  }
+}
+
+// hashlifeRelease returns node that lost the race for insertion.
+local void hashlifeRelease(HashLife* life, u32 id) {
+  pthread_mutex_lock(&life->alloc_lock);
+  HashLifeNode* node = hashlifeNode(life, id);
+  node->level = HASHLIFE_FREE;
+  node->next  = life->free;
+  life->free  = id;
+  life->count--;
+  pthread_mutex_unlock(&life->alloc_lock);
+}
+
+// hashlifeSearch returns node with given quadrants from the chain of the
+// bucket, or 0.
+local u32 hashlifeSearch(HashLife* life, u32 bucket, u32 nw, u32 ne, u32 sw, u32 se) {
+  for (u32 id = life->buckets[bucket]; id != 0;) {
+    HashLifeNode* node = hashlifeNode(life, id);
+    if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) {
+      return id;
+    }
+    id = node->next;
+  }
+  return 0;
+}
+
+// hashlifeFind returns node with given quadrants, node is created when it
+// does not exist.
+local u32 hashlifeFind(HashLife* life, HashLifeThread* thread,
+    u32 nw, u32 ne, u32 sw, u32 se) {
+  u32 bucket = hashlifeHash(nw, ne, sw, se) & life->bucket_mask;
+  pthread_mutex_t* stripe = &life->stripes[bucket & (HASHLIFE_STRIPES - 1)];
+  thread->lookups++;
+
+  if (life->parallel) {
+    pthread_mutex_lock(stripe);
+  }
+  u32 id = hashlifeSearch(life, bucket, nw, ne, sw, se);
+  if (life->parallel) {
+    pthread_mutex_unlock(stripe);
+  }
+  if (id != 0) {
+    thread->found++;
+    return id;
+  }
+
+  // Quadrants are not referenced by any node yet. Stripe is not held, so
+  // the allocation is free to wait for the collection.
+  u32 top = thread->stack_count;
+  hashlifeKeep(thread, nw);
+  hashlifeKeep(thread, ne);
+  hashlifeKeep(thread, sw);
+  hashlifeKeep(thread, se);
+  id = hashlifeAlloc(life);
+  thread->stack_count = top;
+
+  *hashlifeNode(life, id) = (HashLifeNode){
+    .nw     = nw,
+    .ne     = ne,
+    .sw     = sw,
+    .se     = se,
+    .result = HASHLIFE_NONE,
+    .level  = hashlifeNode(life, nw)->level + 1,
+  };
+
+  if (!life->parallel) {
+    hashlifeNode(life, id)->next = life->buckets[bucket];
+    life->buckets[bucket] = id;
+    return id;
+  }
+
+  // Other thread may have inserted the same node meanwhile, there must be
+  // only one of them.
+  pthread_mutex_lock(stripe);
+  u32 existing = hashlifeSearch(life, bucket, nw, ne, sw, se);
+  if (existing == 0) {
+    hashlifeNode(life, id)->next = life->buckets[bucket];
+    life->buckets[bucket] = id;
+  }
+  pthread_mutex_unlock(stripe);
+
+  if (existing != 0) {
+    hashlifeRelease(life, id);
+    return existing;
+  }
+  return id;
+}
+
+// hashlifeEmpty returns empty node of the level.
+local u32 hashlifeEmpty(HashLife* life, HashLifeThread* thread, u32 level) {
+  u32 id = __atomic_load_n(&life->empty[level], __ATOMIC_ACQUIRE);
+  if (id == HASHLIFE_NONE) {
+    u32 empty = hashlifeEmpty(life, thread, level - 1);
+    id = hashlifeFind(life, thread, empty, empty, empty, empty);
+    __atomic_store_n(&life->empty[level], id, __ATOMIC_RELEASE);
+  }
+  return id;
+}
+
+// hashlifeFlush adds counters of the threads to the stats.
+local void hashlifeFlush(HashLife* life) {
+  for (u32 i = 0; i < life->thread_count; i++) {
+    HashLifeThread* thread = &life->threads[i];
+    life->stats.lookups += thread->lookups;
+    life->stats.found   += thread->found;
+    life->stats.hits    += thread->hits;
+    life->stats.misses  += thread->misses;
+    thread->lookups = 0;
+    thread->found   = 0;
+    thread->hits    = 0;
+    thread->misses  = 0;
+  }
+}
+
+usize hashlifeMinMemory(void) {
+  return HASHLIFE_CHUNK * HASHLIFE_NODE_BYTES;
+}
+
+void hashlifeInit(HashLife* life, Rule rule, usize limit) {
+  u32 nodes = min_value(limit / HASHLIFE_NODE_BYTES, HASHLIFE_NONE - 1);
+  assertf(nodes >= HASHLIFE_CHUNK,
+      "Hashlife memory limit %zu is below %zu bytes", limit, hashlifeMinMemory());
+
+  u32 buckets = 1;
+  while (buckets < nodes) {
+    buckets *= 2;
+  }
+
+  *life = (HashLife){
+    .rule         = rule,
+    .table        = gmalloc(1 << 16),
+    .chunks       = gcalloc((nodes >> HASHLIFE_CHUNK_BITS) + 1, sizeof(HashLifeNode*)),
+    .limit        = nodes,
+    .free         = HASHLIFE_NONE,
+    // Untouched buckets stay in the zero pages until they are used.
+    .buckets      = gcalloc(buckets, sizeof(u32)),
+    .bucket_mask  = buckets - 1,
+    .thread_count = workersCount() + 1,
+  };
+  hashlifeTableInit(life);
+
+  for (u32 i = 0; i < HASHLIFE_STRIPES; i++) {
+    pthread_mutex_init(&life->stripes[i], NULL);
+  }
+  pthread_mutex_init(&life->alloc_lock, NULL);
+  pthread_mutex_init(&life->collect_lock, NULL);
+  pthread_cond_init(&life->collected, NULL);
+
+  life->threads = gcalloc(life->thread_count, sizeof(HashLifeThread));
+  for (u32 i = 0; i < life->thread_count; i++) {
+    life->threads[i].stack = gmalloc(HASHLIFE_STACK * sizeof(u32));
+  }
+
+  for (u32 i = 0; i < HASHLIFE_HISTORY; i++) {
+    life->history[i] = HASHLIFE_NONE;
+  }
+  for (u32 level = 0; level <= HASHLIFE_MAX_LEVEL; level++) {
+    life->empty[level] = HASHLIFE_NONE;
+  }
+
+  // Cells are the first two nodes of the pool.
+  for (u32 cell = 0; cell < 2; cell++) {
+    u32 id = hashlifeAlloc(life);
+    *hashlifeNode(life, id) = (HashLifeNode){
+      .result = HASHLIFE_NONE,
+    };
+  }
+  life->empty[0] = 0;
+  life->root     = hashlifeEmpty(life, &life->threads[0], 3);
+}
+
+void hashlifeFree(HashLife* life) {
+  for (u32 i = 0; i < life->capacity; i += HASHLIFE_CHUNK) {
+    gfree(life->chunks[i >> HASHLIFE_CHUNK_BITS]);
+  }
+  for (u32 i = 0; i < life->thread_count; i++) {
+    gfree(life->threads[i].stack);
+  }
+  for (u32 i = 0; i < HASHLIFE_STRIPES; i++) {
+    pthread_mutex_destroy(&life->stripes[i]);
+  }
+  pthread_mutex_destroy(&life->alloc_lock);
+  pthread_mutex_destroy(&life->collect_lock);
+  pthread_cond_destroy(&life->collected);
+
+  gfree(life->table);
+  gfree(life->chunks);
+  gfree(life->buckets);
+  gfree(life->threads);
+  life->table   = NULL;
+  life->chunks  = NULL;
+  life->buckets = NULL;
+  life->threads = NULL;
+}
+
+void hashlifeSetStep(HashLife* life, u32 step) {
+  assertf(step <= HASHLIFE_MAX_STEP, "Hashlife step 2^%u is too large", step);
+  if (step == life->step) {
+    return;
+  }
+
+  life->step = step;
+  hashlifeClearResults(life);
+}
+
+// hashlifeBase advances 4x4 block by single generation.
+local u32 hashlifeBase(HashLife* life, HashLifeThread* thread, u32 id) {
+  HashLifeNode* node = hashlifeNode(life, id);
+  u32 quadrants[4] = { node->nw, node->ne, node->sw, node->se };
+
+  u32 block = 0;
+  for (u32 i = 0; i < 4; i++) {
+    HashLifeNode* quadrant = hashlifeNode(life, quadrants[i]);
+    u32 shift = (i & 1) * 2 + (i >> 1) * 8;
+    block |= (quadrant->nw | quadrant->ne << 1 | quadrant->sw << 4 | quadrant->se << 5) << shift;
+  }
+
+  u8 result = life->table[block];
+  return hashlifeFind(life, thread,
+      result & 1, (result >> 1) & 1, (result >> 2) & 1, result >> 3);
+}
+
+// hashlifeCenter returns center of the node, one level lower.
+local u32 hashlifeCenter(HashLife* life, HashLifeThread* thread, u32 id) {
+  HashLifeNode* node = hashlifeNode(life, id);
+  return hashlifeFind(life, thread,
+      hashlifeNode(life, node->nw)->se, hashlifeNode(life, node->ne)->sw,
+      hashlifeNode(life, node->sw)->ne, hashlifeNode(life, node->se)->nw);
+}
+
+// hashlifeIsFull reports whether result of the node advances it by the half
+// of its size, so both halves of the step advance the subnodes.
+local inline bool hashlifeIsFull(HashLife* life, u32 level) {
+  return level <= life->step + 2;
+}
+
+// hashlifeParts writes nine overlapping subnodes of the half size, they
+// are kept on the stack of the thread.
+local void hashlifeParts(HashLife* life, HashLifeThread* thread, u32 id, u32 parts[9]) {
+  HashLifeNode* node = hashlifeNode(life, id);
+  u32 nw = node->nw;
+  u32 ne = node->ne;
+  u32 sw = node->sw;
+  u32 se = node->se;
+  #define Q(id, quadrant) hashlifeNode(life, id)->quadrant
+
+  parts[0] = nw;
+  parts[1] = hashlifeKeep(thread, hashlifeFind(life, thread, Q(nw, ne), Q(ne, nw), Q(nw, se), Q(ne, sw)));
+  parts[2] = ne;
+  parts[3] = hashlifeKeep(thread, hashlifeFind(life, thread, Q(nw, sw), Q(nw, se), Q(sw, nw), Q(sw, ne)));
+  parts[4] = hashlifeKeep(thread, hashlifeFind(life, thread, Q(nw, se), Q(ne, sw), Q(sw, ne), Q(se, nw)));
+  parts[5] = hashlifeKeep(thread, hashlifeFind(life, thread, Q(ne, sw), Q(ne, se), Q(se, nw), Q(se, ne)));
+  parts[6] = sw;
+  parts[7] = hashlifeKeep(thread, hashlifeFind(life, thread, Q(sw, ne), Q(se, nw), Q(sw, se), Q(se, sw)));
+  parts[8] = se;
+  #undef Q
+}
+
+// hashlifeQuadrant returns node made of four parts with the top left one
+// at the index.
+local u32 hashlifeQuadrant(HashLife* life, HashLifeThread* thread, u32 parts[9], u32 i) {
+  u32 corner = (i >> 1) * 3 + (i & 1);
+  return hashlifeFind(life, thread,
+      parts[corner], parts[corner + 1], parts[corner + 3], parts[corner + 4]);
+}
+
+// hashlifeResult returns center of the node advanced by 2^step
+// generations, nodes below the level step + 2 advance by 2^(level - 2).
+local u32 hashlifeResult(HashLife* life, HashLifeThread* thread, u32 id) {
+  HashLifeNode* node = hashlifeNode(life, id);
+  u32 result = hashlifeResultOf(node);
+  if (result != HASHLIFE_NONE) {
+    thread->hits++;
+    return result;
+  }
+  thread->misses++;
+
+  u32 level = node->level;
+  if (level == 2) {
+    result = hashlifeBase(life, thread, id);
+  } else {
+    u32 top = thread->stack_count;
+    hashlifeKeep(thread, id);
+
+    u32 parts[9];
+    hashlifeParts(life, thread, id, parts);
+
+    // Full step advances both halves, shorter step only the second one.
+    bool full = hashlifeIsFull(life, level);
+    for (u32 i = 0; i < 9; i++) {
+      parts[i] = hashlifeKeep(thread, full
+          ? hashlifeResult(life, thread, parts[i])
+          : hashlifeCenter(life, thread, parts[i]));
+    }
+
+    u32 quadrants[4];
+    for (u32 i = 0; i < 4; i++) {
+      u32 quadrant = hashlifeKeep(thread, hashlifeQuadrant(life, thread, parts, i));
+      quadrants[i] = hashlifeKeep(thread, hashlifeResult(life, thread, quadrant));
+    }
+
+    result = hashlifeFind(life, thread, quadrants[0], quadrants[1], quadrants[2], quadrants[3]);
+    thread->stack_count = top;
+  }
+
+  __atomic_store_n(&hashlifeNode(life, id)->result, result, __ATOMIC_RELEASE);
+  return result;
+}
+
+// HashLifeWave is the list of nodes whose results are computed by the
+// workers, threads take the next node until the list is exhausted.
+typedef struct {
+  HashLife* life;
+  const u32* ids;
+  u32 count;
+  u32 next;
+} HashLifeWave;
+
+local void hashlifeWaveRun(void* ctx, u32 begin, u32 end) {
+  (void)begin;
+  (void)end;
+
+  HashLifeWave* wave = ctx;
+  HashLife* life     = wave->life;
+  u32 index = __atomic_fetch_add(&life->next_thread, 1, __ATOMIC_RELAXED);
+  HashLifeThread* thread = &life->threads[index];
+
+  hashlifeEnter(life);
+  for (;;) {
+    u32 i = __atomic_fetch_add(&wave->next, 1, __ATOMIC_RELAXED);
+    if (i >= wave->count) {
+      break;
+    }
+    hashlifeResult(life, thread, wave->ids[i]);
+  }
+  hashlifeLeave(life);
+}
+
+// hashlifeWave computes results of the nodes on all threads. Results are
+// left in the cache, collection may drop them, then they are computed
+// again when they are asked for.
+local void hashlifeWave(HashLife* life, const u32* ids, u32 count) {
+  HashLifeWave wave = {
+    .life  = life,
+    .ids   = ids,
+    .count = count,
+  };
+
+  life->parallel    = true;
+  life->next_thread = 1;
+  workersRun(workersCount(), hashlifeWaveRun, &wave);
+  life->parallel    = false;
+}
+
+// hashlifePrefetch computes results of the nodes in parallel. While there
+// are too few nodes for the threads, large nodes are split: first the
+// results of their nine parts are prefetched, then the results of their
+// four quadrants, so the result of the node itself is made of the cached
+// results.
+local void hashlifePrefetch(HashLife* life, const u32* ids, u32 count) {
+  HashLifeThread* thread = &life->threads[0];
+
+  u32 split = 0;
+  for (u32 i = 0; i < count; i++) {
+    HashLifeNode* node = hashlifeNode(life, ids[i]);
+    split += node->level >= HASHLIFE_PARALLEL_LEVEL
+      && hashlifeResultOf(node) == HASHLIFE_NONE;
+  }
+  if (split == 0 || count >= workersCount() * HASHLIFE_WAVE_PER_THREAD) {
+    hashlifeWave(life, ids, count);
+    return;
+  }
+
+  u32 top   = thread->stack_count;
+  u32* next = gmalloc(count * 9 * sizeof(u32));
+  u32 next_count = 0;
+
+  for (u32 i = 0; i < count; i++) {
+    HashLifeNode* node = hashlifeNode(life, ids[i]);
+    if (hashlifeResultOf(node) != HASHLIFE_NONE) {
+      continue;
+    }
+    if (node->level < HASHLIFE_PARALLEL_LEVEL) {
+      next[next_count++] = ids[i];
+      continue;
+    }
+    if (hashlifeIsFull(life, node->level)) {
+      hashlifeParts(life, thread, ids[i], &next[next_count]);
+      next_count += 9;
+    }
+  }
+  hashlifePrefetch(life, next, next_count);
+
+  next_count = 0;
+  for (u32 i = 0; i < count; i++) {
+    HashLifeNode* node = hashlifeNode(life, ids[i]);
+    if (node->level < HASHLIFE_PARALLEL_LEVEL || hashlifeResultOf(node) != HASHLIFE_NONE) {
+      continue;
+    }
+
+    u32 parts[9];
+    hashlifeParts(life, thread, ids[i], parts);
+    bool full = hashlifeIsFull(life, node->level);
+    for (u32 j = 0; j < 9; j++) {
+      parts[j] = hashlifeKeep(thread, full
+          ? hashlifeResult(life, thread, parts[j])
+          : hashlifeCenter(life, thread, parts[j]));
+    }
+    for (u32 j = 0; j < 4; j++) {
+      next[next_count++] = hashlifeKeep(thread, hashlifeQuadrant(life, thread, parts, j));
+    }
+  }
+  hashlifePrefetch(life, next, next_count);
+
+  gfree(next);
+  thread->stack_count = top;
+}
+
+// hashlifeExpand doubles the universe around its center.
+local void hashlifeExpand(HashLife* life) {
+  HashLifeThread* thread = &life->threads[0];
+  u32 top   = thread->stack_count;
+  u32 root  = life->root;
+  u32 empty = hashlifeEmpty(life, thread, hashlifeNode(life, root)->level - 1);
+
+  #define Q(quadrant) hashlifeNode(life, root)->quadrant
+  u32 nw = hashlifeKeep(thread, hashlifeFind(life, thread, empty, empty, empty, Q(nw)));
+  u32 ne = hashlifeKeep(thread, hashlifeFind(life, thread, empty, empty, Q(ne), empty));
+  u32 sw = hashlifeKeep(thread, hashlifeFind(life, thread, empty, Q(sw), empty, empty));
+  u32 se = hashlifeKeep(thread, hashlifeFind(life, thread, Q(se), empty, empty, empty));
+  #undef Q
+
+  life->root = hashlifeFind(life, thread, nw, ne, sw, se);
+  thread->stack_count = top;
+}
+
+// hashlifeGrow doubles the universe, returns false when the root is
+// already at the highest level.
+local bool hashlifeGrow(HashLife* life) {
+  if (hashlifeNode(life, life->root)->level >= HASHLIFE_MAX_LEVEL) {
+    return false;
+  }
+  hashlifeExpand(life);
+  return true;
+}
+
+// hashlifeContained reports whether cells of the root are inside its
+// center quarter.
+local bool hashlifeContained(HashLife* life) {
+  u32 empty = hashlifeEmpty(life, &life->threads[0],
+      hashlifeNode(life, life->root)->level - 2);
+  HashLifeNode* root = hashlifeNode(life, life->root);
+  HashLifeNode* nw = hashlifeNode(life, root->nw);
+  HashLifeNode* ne = hashlifeNode(life, root->ne);
+  HashLifeNode* sw = hashlifeNode(life, root->sw);
+  HashLifeNode* se = hashlifeNode(life, root->se);
+
+  return nw->nw == empty && nw->ne == empty && nw->sw == empty
+    && ne->nw == empty && ne->ne == empty && ne->se == empty
+    && sw->nw == empty && sw->sw == empty && sw->se == empty
+    && se->ne == empty && se->sw == empty && se->se == empty;
+}
+
+bool hashlifeStep(HashLife* life) {
+  // Cells spread by at most 2^step during the step, so they must be inside
+  // the center quarter of the result, that is the center eighth of the
+  // root, and the step must not exceed the quarter. Expanded root holds the
+  // same cells, so the universe is left as is when it cannot grow.
+  while (!hashlifeContained(life)) {
+    if (!hashlifeGrow(life)) {
+      return false;
+    }
+  }
+  if (!hashlifeGrow(life)) {
+    return false;
+  }
+  while (hashlifeNode(life, life->root)->level < life->step + 3) {
+    if (!hashlifeGrow(life)) {
+      return false;
+    }
+  }
+
+  if (workersCount() > 1) {
+    hashlifePrefetch(life, &life->root, 1);
+  }
+  life->root = hashlifeResult(life, &life->threads[0], life->root);
+  life->generation += 1ull << life->step;
+
+  life->history[life->history_next] = life->root;
+  life->history_next = (life->history_next + 1) % HASHLIFE_HISTORY;
+  hashlifeFlush(life);
+  return true;
+}
+
+State hashlifeCellState(HashLife* life, i64 x, i64 y) {
+  u32 id   = life->root;
+  i64 half = 1ll << (hashlifeNode(life, id)->level - 1);
+  if (x < -half || x >= half || y < -half || y >= half) {
+    return EMPTY;
+  }
+
+  x += half;
+  y += half;
+  while (hashlifeNode(life, id)->level > 0) {
+    HashLifeNode* node = hashlifeNode(life, id);
+    half = 1ll << (node->level - 1);
+    if (y < half) {
+      id = x < half ? node->nw : node->ne;
+    } else {
+      id = x < half ? node->sw : node->se;
+    }
+    x &= half - 1;
+    y &= half - 1;
+  }
+  return id == 1 ? ALIVE : EMPTY;
+}
+
+// hashlifeSet returns copy of the node with changed cell, coordinates are
+// relative to the top left corner of the node.
+local u32 hashlifeSet(HashLife* life, u32 id, i64 x, i64 y, bool alive) {
+  HashLifeNode* node = hashlifeNode(life, id);
+  if (node->level == 0) {
+    return alive;
+  }
+
+  i64 half = 1ll << (node->level - 1);
+  u32 nw = node->nw;
+  u32 ne = node->ne;
+  u32 sw = node->sw;
+  u32 se = node->se;
+  u32* quadrant = y < half ? (x < half ? &nw : &ne) : (x < half ? &sw : &se);
+  *quadrant = hashlifeSet(life, *quadrant, x & (half - 1), y & (half - 1), alive);
+  return hashlifeFind(life, &life->threads[0], nw, ne, sw, se);
+}
+
+void hashlifeCellSet(HashLife* life, i64 x, i64 y, bool alive) {
+  for (;;) {
+    i64 half = 1ll << (hashlifeNode(life, life->root)->level - 1);
+    if (x >= -half && x < half && y >= -half && y < half) {
+      life->root = hashlifeSet(life, life->root, x + half, y + half, alive);
+      break;
+    }
+    hashlifeExpand(life);
+  }
+  hashlifeFlush(life);
+}
+
+// hashlifeBuild returns node of the level with alive cells of the field,
+// (x, y) is top left corner of the node in the field coordinates.
+local u32 hashlifeBuild(HashLife* life, Field* field, u32 level, i64 x, i64 y) {
+  HashLifeThread* thread = &life->threads[0];
+  i64 size = 1ll << level;
+  if (x >= field->width || y >= field->height || x + size <= 0 || y + size <= 0) {
+    return hashlifeEmpty(life, thread, level);
+  }
+  if (level == 0) {
+    return field->current[fieldCellIndex(field, x, y)] == ALIVE;
+  }
+
+  u32 top  = thread->stack_count;
+  i64 half = size / 2;
+  u32 nw = hashlifeKeep(thread, hashlifeBuild(life, field, level - 1, x, y));
+  u32 ne = hashlifeKeep(thread, hashlifeBuild(life, field, level - 1, x + half, y));
+  u32 sw = hashlifeKeep(thread, hashlifeBuild(life, field, level - 1, x, y + half));
+  u32 se = hashlifeBuild(life, field, level - 1, x + half, y + half);
+  u32 id = hashlifeFind(life, thread, nw, ne, sw, se);
+  thread->stack_count = top;
+  return id;
+}
+
+void hashlifeFromField(HashLife* life, Field* field) {
+  u32 level = 3;
+  while ((1ll << (level - 1)) < max_value(field->width, field->height)) {
+    level++;
+  }
+
+  i64 half = 1ll << (level - 1);
+  life->root = hashlifeBuild(life, field, level,
+      field->width / 2 - half, field->height / 2 - half);
+  hashlifeFlush(life);
+}
+
+// hashlifeDraw writes alive cells of the node with top left corner at
+// (x, y) of the field.
+local void hashlifeDraw(HashLife* life, u32 id, Field* field, i64 x, i64 y) {
+  HashLifeNode* node = hashlifeNode(life, id);
+  i64 size = 1ll << node->level;
+  if (x >= field->width || y >= field->height || x + size <= 0 || y + size <= 0
+      || id == life->empty[node->level]) {
+    return;
+  }
+  if (node->level == 0) {
+    field->current[fieldCellIndex(field, x, y)] = ALIVE;
+    return;
+  }
+
+  i64 half = size / 2;
+  hashlifeDraw(life, node->nw, field, x, y);
+  hashlifeDraw(life, node->ne, field, x + half, y);
+  hashlifeDraw(life, node->sw, field, x, y + half);
+  hashlifeDraw(life, node->se, field, x + half, y + half);
+}
+
+void hashlifeToField(HashLife* life, Field* field, i64 x, i64 y) {
+  // Cells are drawn anew into the other buffer, rows that differ from the
+  // previous cells are marked changed.
+  u8* previous   = field->current;
+  field->current = field->next;
+  field->next    = previous;
+  memset(field->current, EMPTY, (usize)field->pitch * field->height);
+
+  i64 half = 1ll << (hashlifeNode(life, life->root)->level - 1);
+  hashlifeDraw(life, life->root, field, -half - x, -half - y);
+
+  for (u32 row = 0; row < field->height; row++) {
+    usize offset = (usize)row * field->pitch;
+    field->changed[row] = memcmp(field->current + offset, previous + offset, field->width) != 0;
+  }
+}
@@ -0,0 +1,193 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _HASHLIFE_H
+#define _HASHLIFE_H
+
+#include <pthread.h>
+
+#include "types.h"
+#include "field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Highest level of the node, node of the level n is the square of 2^n
+// cells.
+#define HASHLIFE_MAX_LEVEL 62
+// Largest step, the root advanced by 2^step generations is three levels
+// above it.
+#define HASHLIFE_MAX_STEP  (HASHLIFE_MAX_LEVEL - 3)
+// Index that refers to no node.
+#define HASHLIFE_NONE      UINT32_MAX
+// Number of the recent step results kept by the collector.
+#define HASHLIFE_HISTORY   8
+// Number of the locks guarding chains of the hash table.
+#define HASHLIFE_STRIPES   256
+
+// HashLifeNode is the quadtree node, equal nodes are shared through the
+// hash table. Nodes of the level 0 are single cells, index 0 is the dead
+// and index 1 is the alive cell.
+typedef struct {
+  // Quadrants of the node.
+  u32 nw;
+  u32 ne;
+  u32 sw;
+  u32 se;
+  // Cached center of the node advanced by the current step, or by the half
+  // of the node when it is shorter, or HASHLIFE_NONE.
+  u32 result;
+  // Next node in the chain of the hash table or in the free list.
+  u32 next;
+  u8 level;
+  u8 marked;
+} HashLifeNode;
+
+// HashLifeStats holds counters of the node cache.
+typedef struct {
+  // Lookups of the nodes and number of them that found existing node.
+  u64 lookups;
+  u64 found;
+  // Result cache hits and misses.
+  u64 hits;
+  u64 misses;
+  // Number of garbage collections and bytes released by them.
+  u64 collections;
+  u64 reclaimed_bytes;
+  // Memory occupied by the live nodes, now and at most.
+  usize bytes;
+  usize peak_bytes;
+} HashLifeStats;
+
+// HashLifeThread holds nodes used by the computation of the single thread
+// and its cache counters, they are added to the stats after the step.
+typedef struct {
+  u32* stack;
+  u32 stack_count;
+  u64 lookups;
+  u64 found;
+  u64 hits;
+  u64 misses;
+} HashLifeThread;
+
+// HashLife is the infinite life plane with the Moore neighborhood and the
+// deterministic rule, advanced by the Hashlife algorithm. Nodes live in
+// the pool bounded by the memory limit, when the pool is full unreachable
+// nodes are collected. Top levels of the large steps are split into
+// subnodes computed by the worker threads.
+typedef struct {
+  // Rule of the automaton.
+  Rule rule;
+  // Center 2x2 cells of every 4x4 block after single generation.
+  u8* table;
+
+  // Pool of the nodes, chunks are added up to the limit and never move,
+  // so threads read nodes while the pool grows.
+  HashLifeNode** chunks;
+  u32 capacity;
+  u32 limit;
+  // Number of pool entries ever used and number of live nodes.
+  u32 used;
+  u32 count;
+  // Head of the list of the collected nodes.
+  u32 free;
+  // Hash table sized for the limit, chains end with 0 as cells are never
+  // in the table. Chain of the bucket is guarded by the lock of its stripe.
+  u32* buckets;
+  u32 bucket_mask;
+  pthread_mutex_t stripes[HASHLIFE_STRIPES];
+  pthread_mutex_t alloc_lock;
+
+  // Threads that fill the pool during the parallel step park until all
+  // active threads are parked, then the last one collects.
+  bool parallel;
+  pthread_mutex_t collect_lock;
+  pthread_cond_t collected;
+  u32 active;
+  u32 waiting;
+  u64 collect_epoch;
+  // Number of nodes released by the last collection.
+  u32 collect_released;
+
+  // Empty nodes of every level, created on demand.
+  u32 empty[HASHLIFE_MAX_LEVEL + 1];
+  // State of the calling thread followed by the state of every worker.
+  HashLifeThread* threads;
+  u32 thread_count;
+  u32 next_thread;
+
+  // Root of the universe, centered at the origin.
+  u32 root;
+  // Recent roots, ring buffer.
+  u32 history[HASHLIFE_HISTORY];
+  u32 history_next;
+
+  // Single step advances 2^step generations.
+  u32 step;
+  // Number of generations since the start.
+  u64 generation;
+
+  HashLifeStats stats;
+} HashLife;
+
+// hashlifeMinMemory returns the smallest memory limit in bytes accepted by
+// hashlifeInit, it fits a single chunk of the nodes.
+usize hashlifeMinMemory(void);
+
+// hashlifeInit creates empty universe with given rule, memory occupied by
+// the nodes and their cache is bounded by the limit in bytes, that must be
+// at least hashlifeMinMemory. Workers must be initialized before.
+void hashlifeInit(HashLife* life, Rule rule, usize limit);
+void hashlifeFree(HashLife* life);
+
+// hashlifeSetStep sets number of generations of the single step to
+// 2^step, results cached for the previous step are dropped.
+void hashlifeSetStep(HashLife* life, u32 step);
+
+// hashlifeStep advances the universe by the single step. Returns false and
+// keeps the universe when it would grow past HASHLIFE_MAX_LEVEL.
+bool hashlifeStep(HashLife* life);
+
+// hashlifeCollect releases nodes unreachable from the root, the recent
+// step results and the computation in progress.
+void hashlifeCollect(HashLife* life);
+
+// hashlifeCellState returns ALIVE or EMPTY state of the cell.
+State hashlifeCellState(HashLife* life, i64 x, i64 y);
+
+// hashlifeCellSet makes cell alive or dead.
+void hashlifeCellSet(HashLife* life, i64 x, i64 y, bool alive);
+
+// hashlifeFromField replaces universe with alive cells of the field, the
+// field is centered at the origin.
+void hashlifeFromField(HashLife* life, Field* field);
+
+// hashlifeToField writes cells of the universe with top left corner at
+// (x, y) into the field, cells are ALIVE or EMPTY. Rows that differ from
+// the previous cells of the field are flagged changed.
+void hashlifeToField(HashLife* life, Field* field, i64 x, i64 y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
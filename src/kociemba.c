@@ -0,0 +1,870 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "kociemba.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "tables.h"
+#include "workers.h"
+
+// Entry of the pattern database that is not reached yet.
+#define KOCIEMBA_UNKNOWN 15
+// Number of the entries scanned by the single job item.
+#define KOCIEMBA_BLOCK   (1 << 14)
+
+// Moves of the phase 2: all turns of the up and down faces and half turns
+// of the others.
+local const u8 kociemba_phase2[] = { 1, 4, 6, 7, 8, 9, 10, 11, 13, 16 };
+
+
+// kociembaDepth returns entry of the pattern database.
+local inline u32 kociembaDepth(const u32* table, u32 i) {
+  return (table[i >> 3] >> ((i & 7) * 4)) & 15;
+}
+
+RubikMove kociembaMove(u32 move) {
+  u32 face  = move / 3;
+  u32 turns = move % 3 + 1;
+  // Rubik's cube turns layers counterclockwise looking from the positive
+  // side of the axis.
+  RubikMove result = {
+    .axis  = face / 2,
+    .layer = (face & 1) ? 0 : 2,
+    .turns = (face & 1) ? turns : 4 - turns,
+  };
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Cubies
+////////////////////////////////////////////////////////////////////////////////
+
+// kociembaFacelets finds facelets of the corners and edges from the
+// placement of the facelets. Cubies of the up layer go first, then down
+// and then middle layer ones.
+local void kociembaFacelets(Kociemba* solver) {
+  u32 corners = 0;
+  u32 edges[3] = { 0, 4, 8 };
+
+  for (u32 l = 0; l < 2; l++) {
+    for (u32 f = 0; f < 54; f++) {
+      i32 position[3], normal[3];
+      rubikFaceletPlace(3, f, position, normal);
+      if (normal[1] != (l == 0 ? 1 : -1)) {
+        continue;
+      }
+
+      u32 others[2];
+      u32 count = 0;
+      for (u32 g = 0; g < 54; g++) {
+        i32 other[3], other_normal[3];
+        rubikFaceletPlace(3, g, other, other_normal);
+        if (g != f && memcmp(other, position, sizeof(other)) == 0) {
+          others[count++] = g;
+        }
+      }
+
+      if (count == 2) {
+        // Second facelet follows the first one counterclockwise when the
+        // triple product of their normals is positive.
+        i32 a[3], b[3], c[3];
+        rubikFaceletPlace(3, others[0], position, b);
+        rubikFaceletPlace(3, others[1], position, c);
+        rubikFaceletPlace(3, f, position, a);
+        i32 triple = (a[1] * b[2] - a[2] * b[1]) * c[0]
+          + (a[2] * b[0] - a[0] * b[2]) * c[1]
+          + (a[0] * b[1] - a[1] * b[0]) * c[2];
+        u32 first = triple > 0 ? 0 : 1;
+
+        solver->corner_facelets[corners][0] = f;
+        solver->corner_facelets[corners][1] = others[first];
+        solver->corner_facelets[corners][2] = others[1 - first];
+        corners++;
+      } else if (count == 1) {
+        solver->edge_facelets[edges[l]][0] = f;
+        solver->edge_facelets[edges[l]][1] = others[0];
+        edges[l]++;
+      }
+    }
+  }
+
+  // Middle layer edges are referenced by the front and back facelets.
+  for (u32 f = 0; f < 54; f++) {
+    i32 position[3], normal[3];
+    rubikFaceletPlace(3, f, position, normal);
+    if (normal[2] == 0 || position[1] != 0 || position[0] == 0) {
+      continue;
+    }
+    for (u32 g = 0; g < 54; g++) {
+      i32 other[3], other_normal[3];
+      rubikFaceletPlace(3, g, other, other_normal);
+      if (g != f && memcmp(other, position, sizeof(other)) == 0) {
+        solver->edge_facelets[edges[2]][0] = f;
+        solver->edge_facelets[edges[2]][1] = g;
+        edges[2]++;
+      }
+    }
+  }
+
+  assertf(corners == 8 && edges[0] == 4 && edges[1] == 8 && edges[2] == 12,
+      "Unexpected cubies: %u corners, %u/%u/%u edges", corners, edges[0], edges[1], edges[2]);
+
+  // Centers are the only facelets with a single non-zero coordinate.
+  for (u32 f = 0; f < 54; f++) {
+    i32 position[3], normal[3];
+    rubikFaceletPlace(3, f, position, normal);
+    if ((position[0] != 0) + (position[1] != 0) + (position[2] != 0) == 1) {
+      solver->center_facelets[f / 9] = f;
+    }
+  }
+}
+
+// kociembaParity returns parity of the permutation of the distinct values.
+local u32 kociembaParity(const u8* values, u32 count) {
+  u32 parity = 0;
+  for (u32 i = 0; i < count; i++) {
+    for (u32 j = i + 1; j < count; j++) {
+      parity ^= values[j] < values[i];
+    }
+  }
+  return parity;
+}
+
+// kociembaCubie converts facelet colors of the 3x3x3 cube into the cubies.
+// Every color is replaced by the face of the center with that color. Returns
+// false when colors do not form the cubies or the cubies can not be reached
+// by the moves: total twist of the corners, flip of the edges or parities of
+// the permutations are wrong.
+local bool kociembaCubie(const Kociemba* solver, const u8* colors, KociembaCubie* cube) {
+  u8 faces[256];
+  memset(faces, 6, sizeof(faces));
+  for (u32 face = 0; face < 6; face++) {
+    u8 color = colors[solver->center_facelets[face]];
+    if (faces[color] != 6) {
+      return false;
+    }
+    faces[color] = face;
+  }
+
+  u8 facelets[54];
+  for (u32 f = 0; f < 54; f++) {
+    facelets[f] = faces[colors[f]];
+  }
+
+  u32 corners_seen = 0;
+  u32 edges_seen   = 0;
+
+  for (u32 i = 0; i < 8; i++) {
+    const u32* slot = solver->corner_facelets[i];
+    u32 twist = 0;
+    while (twist < 3 && facelets[slot[twist]] != RUBIK_UP && facelets[slot[twist]] != RUBIK_DOWN) {
+      twist++;
+    }
+    if (twist == 3) {
+      return false;
+    }
+
+    u8 first  = facelets[slot[(twist + 1) % 3]];
+    u8 second = facelets[slot[(twist + 2) % 3]];
+    u32 j = 0;
+    while (j < 8 && (first != solver->corner_facelets[j][1] / 9
+          || second != solver->corner_facelets[j][2] / 9)) {
+      j++;
+    }
+    if (j == 8) {
+      return false;
+    }
+    cube->cp[i] = j;
+    cube->co[i] = twist;
+    corners_seen |= 1u << j;
+  }
+
+  for (u32 i = 0; i < 12; i++) {
+    const u32* slot = solver->edge_facelets[i];
+    u8 first  = facelets[slot[0]];
+    u8 second = facelets[slot[1]];
+    u32 j = 0;
+    for (; j < 12; j++) {
+      u8 a = solver->edge_facelets[j][0] / 9;
+      u8 b = solver->edge_facelets[j][1] / 9;
+      if (first == a && second == b) {
+        cube->eo[i] = 0;
+        break;
+      } else if (first == b && second == a) {
+        cube->eo[i] = 1;
+        break;
+      }
+    }
+    if (j == 12) {
+      return false;
+    }
+    cube->ep[i] = j;
+    edges_seen |= 1u << j;
+  }
+
+  if (corners_seen != 0xff || edges_seen != 0xfff) {
+    return false;
+  }
+
+  // Cubies are found by two of their colors, so they are put back to check
+  // the rest of the facelets.
+  for (u32 i = 0; i < 8; i++) {
+    for (u32 k = 0; k < 3; k++) {
+      u32 f = solver->corner_facelets[i][(cube->co[i] + k) % 3];
+      if (facelets[f] != solver->corner_facelets[cube->cp[i]][k] / 9) {
+        return false;
+      }
+    }
+  }
+  for (u32 i = 0; i < 12; i++) {
+    for (u32 k = 0; k < 2; k++) {
+      u32 f = solver->edge_facelets[i][(cube->eo[i] + k) & 1];
+      if (facelets[f] != solver->edge_facelets[cube->ep[i]][k] / 9) {
+        return false;
+      }
+    }
+  }
+
+  u32 twist = 0;
+  u32 flip  = 0;
+  for (u32 i = 0; i < 8; i++) {
+    twist += cube->co[i];
+  }
+  for (u32 i = 0; i < 12; i++) {
+    flip += cube->eo[i];
+  }
+  return twist % 3 == 0 && (flip & 1) == 0
+    && kociembaParity(cube->cp, 8) == kociembaParity(cube->ep, 12);
+}
+
+// kociembaMultiply applies the cubie permutation b after the cube a.
+local void kociembaMultiply(const KociembaCubie* a, const KociembaCubie* b,
+    KociembaCubie* out) {
+  for (u32 i = 0; i < 8; i++) {
+    out->cp[i] = a->cp[b->cp[i]];
+    out->co[i] = (a->co[b->cp[i]] + b->co[i]) % 3;
+  }
+  for (u32 i = 0; i < 12; i++) {
+    out->ep[i] = a->ep[b->ep[i]];
+    out->eo[i] = a->eo[b->ep[i]] ^ b->eo[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Coordinates
+////////////////////////////////////////////////////////////////////////////////
+
+// kociembaChoose returns binomial coefficient.
+local u32 kociembaChoose(u32 n, u32 k) {
+  if (k > n) {
+    return 0;
+  }
+  u32 result = 1;
+  for (u32 i = 1; i <= k; i++) {
+    result = result * (n - k + i) / i;
+  }
+  return result;
+}
+
+local u32 kociembaTwist(const KociembaCubie* cube) {
+  u32 twist = 0;
+  for (u32 i = 0; i < 7; i++) {
+    twist = twist * 3 + cube->co[i];
+  }
+  return twist;
+}
+
+local u32 kociembaFlip(const KociembaCubie* cube) {
+  u32 flip = 0;
+  for (u32 i = 0; i < 11; i++) {
+    flip = flip * 2 + cube->eo[i];
+  }
+  return flip;
+}
+
+// kociembaSlice returns index of the positions of the middle layer edges.
+local u32 kociembaSlice(const KociembaCubie* cube) {
+  u32 slice = 0;
+  u32 found = 0;
+  for (i32 j = 11; j >= 0; j--) {
+    if (cube->ep[j] >= 8) {
+      slice += kociembaChoose(11 - j, found + 1);
+      found++;
+    }
+  }
+  return slice;
+}
+
+// kociembaPerm returns index of the permutation of the distinct values.
+local u32 kociembaPerm(const u8* values, u32 count) {
+  u32 index = 0;
+  for (u32 i = 0; i < count; i++) {
+    u32 smaller = 0;
+    for (u32 j = i + 1; j < count; j++) {
+      smaller += values[j] < values[i];
+    }
+    index = index * (count - i) + smaller;
+  }
+  return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Tables
+////////////////////////////////////////////////////////////////////////////////
+
+// Number of the entries of every pattern database.
+local const u32 kociemba_entries[KOCIEMBA_TABLES] = {
+  [KOCIEMBA_TWIST_SLICE] = KOCIEMBA_SLICE * KOCIEMBA_TWIST,
+  [KOCIEMBA_FLIP_SLICE]  = KOCIEMBA_SLICE * KOCIEMBA_FLIP,
+  [KOCIEMBA_CORNERS]     = KOCIEMBA_PERM * KOCIEMBA_SLICE_PERM,
+  [KOCIEMBA_EDGES]       = KOCIEMBA_PERM * KOCIEMBA_SLICE_PERM,
+};
+
+local void kociembaIdentity(KociembaCubie* cube) {
+  for (u32 i = 0; i < 8; i++) {
+    cube->cp[i] = i;
+    cube->co[i] = 0;
+  }
+  for (u32 i = 0; i < 12; i++) {
+    cube->ep[i] = i;
+    cube->eo[i] = 0;
+  }
+}
+
+local void kociembaSetTwist(KociembaCubie* cube, u32 twist) {
+  u32 sum = 0;
+  for (i32 i = 6; i >= 0; i--) {
+    cube->co[i] = twist % 3;
+    sum  += cube->co[i];
+    twist /= 3;
+  }
+  cube->co[7] = (3 - sum % 3) % 3;
+}
+
+local void kociembaSetFlip(KociembaCubie* cube, u32 flip) {
+  u32 sum = 0;
+  for (i32 i = 10; i >= 0; i--) {
+    cube->eo[i] = flip & 1;
+    sum  += cube->eo[i];
+    flip >>= 1;
+  }
+  cube->eo[11] = sum & 1;
+}
+
+local void kociembaSetSlice(KociembaCubie* cube, u32 slice) {
+  u32 left  = 4;
+  u32 other = 0;
+  for (u32 j = 0; j < 12; j++) {
+    u32 choose = kociembaChoose(11 - j, left);
+    if (left > 0 && slice >= choose) {
+      cube->ep[j] = 12 - left;
+      slice -= choose;
+      left--;
+    } else {
+      cube->ep[j] = other++;
+    }
+  }
+}
+
+// kociembaSetPerm writes permutation of the values [offset, offset + count)
+// with the index.
+local void kociembaSetPerm(u8* values, u32 count, u32 offset, u32 index) {
+  u8 digits[12];
+  for (i32 i = count - 1; i >= 0; i--) {
+    digits[i] = index % (count - i);
+    index    /= count - i;
+  }
+
+  u8 unused[12];
+  for (u32 i = 0; i < count; i++) {
+    unused[i] = offset + i;
+  }
+  for (u32 i = 0; i < count; i++) {
+    values[i] = unused[digits[i]];
+    memmove(unused + digits[i], unused + digits[i] + 1, count - i - digits[i] - 1);
+  }
+}
+
+// Coordinate of the move tables.
+typedef enum {
+  KOCIEMBA_COORD_TWIST,
+  KOCIEMBA_COORD_FLIP,
+  KOCIEMBA_COORD_SLICE,
+  KOCIEMBA_COORD_CORNERS,
+  KOCIEMBA_COORD_EDGES,
+  KOCIEMBA_COORD_SLICE_PERM,
+} KociembaCoord;
+
+local void kociembaSetCoord(KociembaCubie* cube, KociembaCoord coord, u32 value) {
+  kociembaIdentity(cube);
+  switch (coord) {
+    case KOCIEMBA_COORD_TWIST:      kociembaSetTwist(cube, value); break;
+    case KOCIEMBA_COORD_FLIP:       kociembaSetFlip(cube, value); break;
+    case KOCIEMBA_COORD_SLICE:      kociembaSetSlice(cube, value); break;
+    case KOCIEMBA_COORD_CORNERS:    kociembaSetPerm(cube->cp, 8, 0, value); break;
+    case KOCIEMBA_COORD_EDGES:      kociembaSetPerm(cube->ep, 8, 0, value); break;
+    case KOCIEMBA_COORD_SLICE_PERM: kociembaSetPerm(cube->ep + 8, 4, 8, value); break;
+  }
+}
+
+local u32 kociembaCoord(const KociembaCubie* cube, KociembaCoord coord) {
+  switch (coord) {
+    case KOCIEMBA_COORD_TWIST:      return kociembaTwist(cube);
+    case KOCIEMBA_COORD_FLIP:       return kociembaFlip(cube);
+    case KOCIEMBA_COORD_SLICE:      return kociembaSlice(cube);
+    case KOCIEMBA_COORD_CORNERS:    return kociembaPerm(cube->cp, 8);
+    case KOCIEMBA_COORD_EDGES:      return kociembaPerm(cube->ep, 8);
+    case KOCIEMBA_COORD_SLICE_PERM: return kociembaPerm(cube->ep + 8, 4);
+  }
+  return 0;
+}
+
+// kociembaMoveTable writes coordinates after every move. Permutations of
+// the edges are valid only for the moves of the phase 2.
+local void kociembaMoveTable(u16* table, const KociembaCubie* moves, KociembaCoord coord,
+    u32 count) {
+  for (u32 i = 0; i < count; i++) {
+    KociembaCubie cube, next;
+    kociembaSetCoord(&cube, coord, i);
+    for (u32 m = 0; m < KOCIEMBA_MOVES; m++) {
+      kociembaMultiply(&cube, &moves[m], &next);
+      table[i * KOCIEMBA_MOVES + m] = kociembaCoord(&next, coord);
+    }
+  }
+}
+
+// KociembaFill fills pattern database of the pair of the coordinates with
+// the index first * second_count + second.
+typedef struct {
+  u32* table;
+  u32 entries;
+  const u16* first_moves;
+  const u16* second_moves;
+  u32 second_count;
+  const u8* moves;
+  u32 move_count;
+  u32 depth;
+  u32 filled;
+} KociembaFill;
+
+local void kociembaFillBlocks(void* ctx, u32 begin, u32 end) {
+  KociembaFill* job = ctx;
+  u32 from   = begin * KOCIEMBA_BLOCK;
+  u32 to     = min_value(end * KOCIEMBA_BLOCK, job->entries);
+  u32 filled = 0;
+
+  for (u32 i = from; i < to; i++) {
+    u32 entry = __atomic_load_n(&job->table[i >> 3], __ATOMIC_RELAXED) >> ((i & 7) * 4);
+    if ((entry & 15) != job->depth) {
+      continue;
+    }
+
+    u32 first  = i / job->second_count;
+    u32 second = i % job->second_count;
+    for (u32 k = 0; k < job->move_count; k++) {
+      u32 m    = job->moves[k];
+      u32 next = job->first_moves[first * KOCIEMBA_MOVES + m] * job->second_count
+        + job->second_moves[second * KOCIEMBA_MOVES + m];
+
+      // Entries share words with the entries of the other threads.
+      u32* word  = &job->table[next >> 3];
+      u32 shift  = (next & 7) * 4;
+      u32 value  = __atomic_load_n(word, __ATOMIC_RELAXED);
+      while (((value >> shift) & 15) == KOCIEMBA_UNKNOWN) {
+        u32 update = (value & ~(15u << shift)) | ((job->depth + 1) << shift);
+        if (__atomic_compare_exchange_n(word, &value, update, false,
+              __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+          filled++;
+          break;
+        }
+      }
+    }
+  }
+
+  __atomic_fetch_add(&job->filled, filled, __ATOMIC_RELAXED);
+}
+
+// kociembaFill fills pattern database breadth first, every level is
+// expanded on the worker threads.
+local void kociembaFill(u32* table, u32 entries, const u16* first_moves,
+    const u16* second_moves, u32 second_count, const u8* moves, u32 move_count) {
+  memset(table, 0xff, KOCIEMBA_WORDS(entries) * sizeof(u32));
+  table[0] &= ~15u;
+
+  KociembaFill job = {
+    .table        = table,
+    .entries      = entries,
+    .first_moves  = first_moves,
+    .second_moves = second_moves,
+    .second_count = second_count,
+    .moves        = moves,
+    .move_count   = move_count,
+  };
+
+  u32 total = 1;
+  for (u32 depth = 0; total < entries && depth + 1 < KOCIEMBA_UNKNOWN; depth++) {
+    job.depth  = depth;
+    job.filled = 0;
+    workersRun((entries + KOCIEMBA_BLOCK - 1) / KOCIEMBA_BLOCK, kociembaFillBlocks, &job);
+    if (job.filled == 0) {
+      break;
+    }
+    total += job.filled;
+  }
+}
+
+// Header of the file of the tables, tables follow it in the layout of
+// kociembaLayout.
+#define KOCIEMBA_MAGIC   0x314b4f43u
+#define KOCIEMBA_VERSION 2
+
+typedef struct {
+  u32 magic;
+  u32 version;
+  u64 size;
+} KociembaHeader;
+
+// kociembaSize returns size of the memory of all tables.
+local usize kociembaSize(void) {
+  usize size = ((usize)KOCIEMBA_TWIST + KOCIEMBA_FLIP + KOCIEMBA_SLICE + 2 * KOCIEMBA_PERM
+      + KOCIEMBA_SLICE_PERM) * KOCIEMBA_MOVES * sizeof(u16);
+  for (u32 t = 0; t < KOCIEMBA_TABLES; t++) {
+    size += KOCIEMBA_WORDS(kociemba_entries[t]) * sizeof(u32);
+  }
+  return size;
+}
+
+// kociembaLayout points the solver to the tables in the memory. Pattern
+// databases go first to keep their words aligned.
+local void kociembaLayout(Kociemba* solver, const void* memory) {
+  const u32* words = memory;
+  for (u32 t = 0; t < KOCIEMBA_TABLES; t++) {
+    solver->tables[t] = words;
+    words += KOCIEMBA_WORDS(kociemba_entries[t]);
+  }
+
+  solver->twist_moves      = (const u16*)words;
+  solver->flip_moves       = solver->twist_moves + KOCIEMBA_TWIST * KOCIEMBA_MOVES;
+  solver->slice_moves      = solver->flip_moves + KOCIEMBA_FLIP * KOCIEMBA_MOVES;
+  solver->corner_moves     = solver->slice_moves + KOCIEMBA_SLICE * KOCIEMBA_MOVES;
+  solver->edge_moves       = solver->corner_moves + KOCIEMBA_PERM * KOCIEMBA_MOVES;
+  solver->slice_perm_moves = solver->edge_moves + KOCIEMBA_PERM * KOCIEMBA_MOVES;
+}
+
+// kociembaGenerate computes move tables and fills pattern databases in the
+// memory.
+local void kociembaGenerate(Kociemba* solver) {
+  solver->generated = gmalloc(kociembaSize());
+  kociembaLayout(solver, solver->generated);
+
+  u32* tables[KOCIEMBA_TABLES];
+  for (u32 t = 0; t < KOCIEMBA_TABLES; t++) {
+    tables[t] = (u32*)solver->tables[t];
+  }
+  u16* twist_moves      = (u16*)solver->twist_moves;
+  u16* flip_moves       = (u16*)solver->flip_moves;
+  u16* slice_moves      = (u16*)solver->slice_moves;
+  u16* corner_moves     = (u16*)solver->corner_moves;
+  u16* edge_moves       = (u16*)solver->edge_moves;
+  u16* slice_perm_moves = (u16*)solver->slice_perm_moves;
+
+  const KociembaCubie* moves = solver->moves;
+  kociembaMoveTable(twist_moves, moves, KOCIEMBA_COORD_TWIST, KOCIEMBA_TWIST);
+  kociembaMoveTable(flip_moves, moves, KOCIEMBA_COORD_FLIP, KOCIEMBA_FLIP);
+  kociembaMoveTable(slice_moves, moves, KOCIEMBA_COORD_SLICE, KOCIEMBA_SLICE);
+  kociembaMoveTable(corner_moves, moves, KOCIEMBA_COORD_CORNERS, KOCIEMBA_PERM);
+  kociembaMoveTable(edge_moves, moves, KOCIEMBA_COORD_EDGES, KOCIEMBA_PERM);
+  kociembaMoveTable(slice_perm_moves, moves, KOCIEMBA_COORD_SLICE_PERM, KOCIEMBA_SLICE_PERM);
+
+  u8 all_moves[KOCIEMBA_MOVES];
+  for (u32 m = 0; m < KOCIEMBA_MOVES; m++) {
+    all_moves[m] = m;
+  }
+  kociembaFill(tables[KOCIEMBA_TWIST_SLICE], kociemba_entries[KOCIEMBA_TWIST_SLICE],
+      slice_moves, twist_moves, KOCIEMBA_TWIST, all_moves, KOCIEMBA_MOVES);
+  kociembaFill(tables[KOCIEMBA_FLIP_SLICE], kociemba_entries[KOCIEMBA_FLIP_SLICE],
+      slice_moves, flip_moves, KOCIEMBA_FLIP, all_moves, KOCIEMBA_MOVES);
+  kociembaFill(tables[KOCIEMBA_CORNERS], kociemba_entries[KOCIEMBA_CORNERS],
+      corner_moves, slice_perm_moves, KOCIEMBA_SLICE_PERM,
+      kociemba_phase2, sizeof(kociemba_phase2));
+  kociembaFill(tables[KOCIEMBA_EDGES], kociemba_entries[KOCIEMBA_EDGES],
+      edge_moves, slice_perm_moves, KOCIEMBA_SLICE_PERM,
+      kociemba_phase2, sizeof(kociemba_phase2));
+}
+
+// kociembaMap maps tables from the file. Returns false when the file is
+// missing or does not match the tables.
+local bool kociembaMap(Kociemba* solver, const char* path) {
+  i32 fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  usize size = sizeof(KociembaHeader) + kociembaSize();
+  struct stat info;
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && (usize)info.st_size == size) {
+    mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  const KociembaHeader* header = mapping;
+  if (header->magic != KOCIEMBA_MAGIC || header->version != KOCIEMBA_VERSION
+      || header->size != kociembaSize()) {
+    munmap(mapping, size);
+    return false;
+  }
+
+  kociembaLayout(solver, header + 1);
+  solver->mapping      = mapping;
+  solver->mapping_size = size;
+  return true;
+}
+
+// kociembaSave writes generated tables into the file, the file is replaced
+// only when it is written completely.
+local void kociembaSave(Kociemba* solver, const char* path) {
+  char temporary[4096];
+  snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+  FILE* file = fopen(temporary, "wb");
+  if (file == NULL) {
+    return;
+  }
+
+  KociembaHeader header = {
+    .magic   = KOCIEMBA_MAGIC,
+    .version = KOCIEMBA_VERSION,
+    .size    = kociembaSize(),
+  };
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1
+    && fwrite(solver->generated, 1, header.size, file) == header.size;
+
+  if (fclose(file) == 0 && written) {
+    rename(temporary, path);
+  } else {
+    remove(temporary);
+  }
+}
+
+bool kociembaInit(Kociemba* solver, const char* path) {
+  memset(solver, 0, sizeof(*solver));
+  kociembaFacelets(solver);
+
+  // Cubies of the face moves are read from the moved facelets.
+  RubikCube cube;
+  rubikInit(&cube, 3);
+  for (u32 m = 0; m < KOCIEMBA_MOVES; m++) {
+    rubikReset(&cube);
+    rubikMove(&cube, kociembaMove(m));
+    bool valid = kociembaCubie(solver, cube.facelets, &solver->moves[m]);
+    assertf(valid, "Move %u does not give valid cube", m);
+  }
+  rubikFree(&cube);
+
+  const void* embedded = tablesGet(TABLE_KOCIEMBA, kociembaSize());
+  if (embedded != NULL) {
+    kociembaLayout(solver, embedded);
+    return true;
+  }
+  if (path != NULL && kociembaMap(solver, path)) {
+    return true;
+  }
+
+  kociembaGenerate(solver);
+  if (path != NULL) {
+    kociembaSave(solver, path);
+  }
+  return false;
+}
+
+const void* kociembaTables(const Kociemba* solver, usize* size) {
+  *size = kociembaSize();
+  return solver->tables[0];
+}
+
+void kociembaFree(Kociemba* solver) {
+  if (solver->mapping != NULL) {
+    munmap(solver->mapping, solver->mapping_size);
+  }
+  if (solver->generated != NULL) {
+    gfree(solver->generated);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Search
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  const Kociemba* solver;
+  KociembaCubie cube;
+  u32 max_length;
+  u8 moves[KOCIEMBA_MAX_LENGTH];
+  u32 length;
+  // Number of the visited nodes, the search gives up past the limit.
+  u32 nodes;
+} KociembaSearch;
+
+// kociembaSkip reports whether the move is redundant after the previous
+// one: turns of the same face are merged and turns of the opposite faces
+// commute, so they go in the single order.
+local inline bool kociembaSkip(KociembaSearch* search, u32 depth, u32 move) {
+  if (depth == 0) {
+    return false;
+  }
+  u32 face = move / 3;
+  u32 last = search->moves[depth - 1] / 3;
+  return face == last || (face == (last ^ 1) && face < last);
+}
+
+local bool kociembaPhase2(KociembaSearch* search, u32 corners, u32 edges, u32 slice,
+    u32 depth, u32 togo) {
+  if (++search->nodes > KOCIEMBA_MAX_NODES) {
+    return false;
+  }
+  if (togo == 0) {
+    if (corners == 0 && edges == 0 && slice == 0) {
+      search->length = depth;
+      return true;
+    }
+    return false;
+  }
+
+  const Kociemba* solver = search->solver;
+  u32 bound = max_value(
+      kociembaDepth(solver->tables[KOCIEMBA_CORNERS], corners * KOCIEMBA_SLICE_PERM + slice),
+      kociembaDepth(solver->tables[KOCIEMBA_EDGES], edges * KOCIEMBA_SLICE_PERM + slice));
+  if (bound > togo) {
+    return false;
+  }
+
+  for (u32 k = 0; k < sizeof(kociemba_phase2); k++) {
+    u32 m = kociemba_phase2[k];
+    if (kociembaSkip(search, depth, m)) {
+      continue;
+    }
+    search->moves[depth] = m;
+    if (kociembaPhase2(search,
+          solver->corner_moves[corners * KOCIEMBA_MOVES + m],
+          solver->edge_moves[edges * KOCIEMBA_MOVES + m],
+          solver->slice_perm_moves[slice * KOCIEMBA_MOVES + m],
+          depth + 1, togo - 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// kociembaStartPhase2 applies moves of the phase 1 to the cube and solves
+// it with the moves left.
+local bool kociembaStartPhase2(KociembaSearch* search, u32 depth) {
+  // Phase 1 that ends with the move of the phase 2 was already tried
+  // without that move.
+  if (depth > 0 && memchr(kociemba_phase2, search->moves[depth - 1], sizeof(kociemba_phase2))) {
+    return false;
+  }
+
+  KociembaCubie cube = search->cube;
+  for (u32 i = 0; i < depth; i++) {
+    KociembaCubie next;
+    kociembaMultiply(&cube, &search->solver->moves[search->moves[i]], &next);
+    cube = next;
+  }
+
+  u32 corners = kociembaPerm(cube.cp, 8);
+  u32 edges   = kociembaPerm(cube.ep, 8);
+  u32 slice   = kociembaPerm(cube.ep + 8, 4);
+  for (u32 togo = 0; depth + togo <= search->max_length; togo++) {
+    if (kociembaPhase2(search, corners, edges, slice, depth, togo)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+local bool kociembaPhase1(KociembaSearch* search, u32 twist, u32 flip, u32 slice,
+    u32 depth, u32 togo) {
+  if (++search->nodes > KOCIEMBA_MAX_NODES) {
+    return false;
+  }
+  if (togo == 0) {
+    return twist == 0 && flip == 0 && slice == 0 && kociembaStartPhase2(search, depth);
+  }
+
+  const Kociemba* solver = search->solver;
+  u32 bound = max_value(
+      kociembaDepth(solver->tables[KOCIEMBA_TWIST_SLICE], slice * KOCIEMBA_TWIST + twist),
+      kociembaDepth(solver->tables[KOCIEMBA_FLIP_SLICE], slice * KOCIEMBA_FLIP + flip));
+  if (bound > togo) {
+    return false;
+  }
+
+  for (u32 m = 0; m < KOCIEMBA_MOVES; m++) {
+    if (kociembaSkip(search, depth, m)) {
+      continue;
+    }
+    search->moves[depth] = m;
+    if (kociembaPhase1(search,
+          solver->twist_moves[twist * KOCIEMBA_MOVES + m],
+          solver->flip_moves[flip * KOCIEMBA_MOVES + m],
+          solver->slice_moves[slice * KOCIEMBA_MOVES + m],
+          depth + 1, togo - 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+i32 kociembaSolve(const Kociemba* solver, const RubikCube* cube, u32 max_length,
+    u8* moves) {
+  KociembaSearch search = {
+    .solver     = solver,
+    .max_length = min_value(max_length, KOCIEMBA_MAX_LENGTH),
+  };
+  if (cube->size != 3 || !kociembaCubie(solver, cube->facelets, &search.cube)) {
+    return -1;
+  }
+
+  u32 twist = kociembaTwist(&search.cube);
+  u32 flip  = kociembaFlip(&search.cube);
+  u32 slice = kociembaSlice(&search.cube);
+  for (u32 depth = 0; depth <= search.max_length; depth++) {
+    if (kociembaPhase1(&search, twist, flip, slice, 0, depth)) {
+      memcpy(moves, search.moves, search.length);
+      return search.length;
+    }
+    if (search.nodes > KOCIEMBA_MAX_NODES) {
+      break;
+    }
+  }
+  return -1;
+}
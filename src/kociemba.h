@@ -0,0 +1,131 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _KOCIEMBA_H
+#define _KOCIEMBA_H
+
+// Two-phase solver of the 3x3x3 Rubik's cube. Phase 1 brings the cube into
+// the subgroup <U, D, R2, L2, F2, B2>: corners and edges are oriented and
+// middle layer edges are in the middle layer. Phase 2 solves the cube with
+// the moves of the subgroup. Both phases are IDA* searches over the
+// coordinates of the cube guided by the pattern databases.
+
+#include "types.h"
+#include "rubik.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of the face moves, move 3 * face + k turns the face clockwise by
+// k + 1 quarter turns, faces are in the order of RubikFace.
+#define KOCIEMBA_MOVES      18
+// Longest solution the solver looks for.
+#define KOCIEMBA_MAX_LENGTH 30
+// Number of the search nodes after which the solver gives up.
+#define KOCIEMBA_MAX_NODES  (1u << 24)
+
+// Sizes of the coordinates.
+#define KOCIEMBA_TWIST      2187
+#define KOCIEMBA_FLIP       2048
+#define KOCIEMBA_SLICE      495
+#define KOCIEMBA_PERM       40320
+#define KOCIEMBA_SLICE_PERM 24
+
+// Pattern databases of the pairs of the coordinates, they hold the number
+// of the moves to the goal in 4 bits per entry.
+typedef enum {
+  KOCIEMBA_TWIST_SLICE = 0,
+  KOCIEMBA_FLIP_SLICE  = 1,
+  KOCIEMBA_CORNERS     = 2,
+  KOCIEMBA_EDGES       = 3,
+  KOCIEMBA_TABLES      = 4,
+} KociembaTable;
+
+// Number of the 32-bit words of the pattern database with the given number
+// of the entries.
+#define KOCIEMBA_WORDS(entries) (((entries) + 7) / 8)
+
+// KociembaCubie holds cubie at every position and its orientation. Corners
+// 0-3 are in the up layer, edges 0-3 in the up layer, 4-7 in the down layer
+// and 8-11 in the middle layer.
+typedef struct {
+  u8 cp[8];
+  u8 co[8];
+  u8 ep[12];
+  u8 eo[12];
+} KociembaCubie;
+
+typedef struct {
+  // Facelets of the corners and edges of the 3x3x3 cube, the first one is
+  // on the up or down face, for the middle layer edges on the front or
+  // back face. Corner facelets go counterclockwise.
+  u32 corner_facelets[8][3];
+  u32 edge_facelets[12][2];
+  // Center facelet of every face.
+  u32 center_facelets[6];
+  // Cubies of the face moves applied to the solved cube.
+  KociembaCubie moves[KOCIEMBA_MOVES];
+
+  // Coordinates after every move.
+  const u16* twist_moves;
+  const u16* flip_moves;
+  const u16* slice_moves;
+  const u16* corner_moves;
+  const u16* edge_moves;
+  const u16* slice_perm_moves;
+
+  // Pattern databases, eight entries per word. Tables are embedded into the
+  // binary, mapped from the file or generated into the memory.
+  const u32* tables[KOCIEMBA_TABLES];
+  void* mapping;
+  usize mapping_size;
+  u32* generated;
+} Kociemba;
+
+// kociembaInit prepares the solver. Tables embedded by tablegen are used
+// when the binary has them, otherwise they are mapped from the file. Missing
+// or invalid file is replaced with the tables generated on the worker
+// threads, NULL path skips the file. Returns whether tables were loaded
+// without generating them.
+bool kociembaInit(Kociemba* solver, const char* path);
+void kociembaFree(Kociemba* solver);
+
+// kociembaTables returns memory of all tables of the solver in the layout
+// embedded by tablegen.
+const void* kociembaTables(const Kociemba* solver, usize* size);
+
+// kociembaMove returns layer move of the 3x3x3 cube for the face move.
+RubikMove kociembaMove(u32 move);
+
+// kociembaSolve writes at most max_length face moves that solve the 3x3x3
+// cube. Colors are read relative to the centers, so the cube turned by the
+// middle layers is solved into the orientation of its centers. Returns
+// number of the moves, or -1 when the cube is not valid, has no solution
+// of that length or the search visits more than KOCIEMBA_MAX_NODES nodes.
+i32 kociembaSolve(const Kociemba* solver, const RubikCube* cube, u32 max_length,
+    u8* moves);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
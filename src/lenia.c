@@ -0,0 +1,157 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lenia.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "simd.h"
+#include "workers.h"
+
+local i32 leniaWrap(i32 a, i32 stride) {
+  // stride is a power of two
+  return a & (stride - 1);
+}
+
+// leniaKernelCore is a smooth bump on (0, 1) that forms a single ring.
+local f64 leniaKernelCore(f64 r) {
+  if (r <= 0.0 || r >= 1.0) {
+    return 0.0;
+  }
+  return exp(4.0 - 1.0 / (r * (1.0 - r)));
+}
+
+local void leniaKernelInit(Lenia* lenia) {
+  u32 stride = lenia->stride;
+  i32 radius = lenia->params.radius;
+
+  assertf((u32)radius * 2 < stride,
+      "Kernel radius %d does not fit into the field %u", radius, stride);
+
+  f32* image = gcalloc((usize)stride * stride, sizeof(f32));
+
+  // Kernel is centered at the origin and wrapped around the torus, so
+  // the convolution does not shift the field.
+  f64 sum = 0;
+  for (i32 dy = -radius; dy <= radius; dy++) {
+    for (i32 dx = -radius; dx <= radius; dx++) {
+      f64 r = sqrt(square(dx) + square(dy)) / radius;
+      f64 k = leniaKernelCore(r);
+      if (k > 0) {
+        image[leniaWrap(dy, stride) * stride + leniaWrap(dx, stride)] = k;
+        sum += k;
+      }
+    }
+  }
+
+  // Normalize kernel to sum to 1 and compensate unnormalized transform.
+  f64 scale = 1.0 / (sum * stride * stride);
+  for (usize i = 0; i < (usize)stride * stride; i++) {
+    image[i] *= scale;
+  }
+
+  fft2dForward(&lenia->fft, image, lenia->kernel);
+  gfree(image);
+}
+
+void leniaInit(Lenia* lenia, u32 stride, LeniaParams params) {
+  usize size  = (usize)stride * stride;
+  usize count = (usize)(stride / 2 + 1) * stride;
+
+  lenia->stride    = stride;
+  lenia->params    = params;
+  lenia->current   = gcalloc(size, sizeof(f32));
+  lenia->potential = gcalloc(size, sizeof(f32));
+  lenia->spectrum  = gcalloc(count, sizeof(Complex));
+  lenia->kernel    = gcalloc(count, sizeof(Complex));
+
+  fft2dInit(&lenia->fft, stride, stride);
+  leniaKernelInit(lenia);
+}
+
+void leniaFree(Lenia* lenia) {
+  fft2dFree(&lenia->fft);
+  gfree(lenia->current);
+  gfree(lenia->potential);
+  gfree(lenia->spectrum);
+  gfree(lenia->kernel);
+}
+
+void leniaCellSet(Lenia* lenia, i32 x, i32 y, f32 value) {
+  u32 stride = lenia->stride;
+  lenia->current[leniaWrap(y, stride) * stride + leniaWrap(x, stride)] = value;
+}
+
+void leniaSeed(Lenia* lenia, i32 x, i32 y, u32 size) {
+  i32 half = size / 2;
+  for (i32 dy = -half; dy < half; dy++) {
+    for (i32 dx = -half; dx < half; dx++) {
+      leniaCellSet(lenia, x + dx, y + dy, (f32)rand() / RAND_MAX);
+    }
+  }
+}
+
+local void leniaMultiply(void* ctx, u32 begin, u32 end) {
+  Lenia* lenia = ctx;
+  usize count  = fft2dSpectrumWidth(&lenia->fft);
+
+  Complex* spectrum = lenia->spectrum + begin * count;
+  Complex* kernel   = lenia->kernel + begin * count;
+
+  for (usize i = 0; i < (end - begin) * count; i++) {
+    Complex a = spectrum[i];
+    Complex b = kernel[i];
+    spectrum[i].re = a.re * b.re - a.im * b.im;
+    spectrum[i].im = a.re * b.im + a.im * b.re;
+  }
+}
+
+// leniaGrow applies growth function to the rows in range, stride is
+// always a multiple of the vector width.
+local void leniaGrow(void* ctx, u32 begin, u32 end) {
+  Lenia* lenia = ctx;
+
+  f32 dt    = lenia->params.dt;
+  f32 mu    = lenia->params.mu;
+  f32 scale = -1.0f / (2.0f * square(lenia->params.sigma));
+
+  usize from = (usize)begin * lenia->stride;
+  usize to   = (usize)end * lenia->stride;
+
+  for (usize i = from; i < to; i += F32X4_LANES) {
+    f32x4 u = f32x4Load(lenia->potential + i);
+    f32x4 a = f32x4Load(lenia->current + i);
+
+    f32x4 d = u - mu;
+    f32x4 g = f32x4Exp(d * d * scale) * 2.0f - 1.0f;
+
+    f32x4Store(lenia->current + i, f32x4Clamp(a + g * dt, 0.0f, 1.0f));
+  }
+}
+
+void leniaUpdate(Lenia* lenia) {
+  fft2dForward(&lenia->fft, lenia->current, lenia->spectrum);
+  workersRun(lenia->stride, leniaMultiply, lenia);
+  fft2dInverse(&lenia->fft, lenia->spectrum, lenia->potential);
+  workersRun(lenia->stride, leniaGrow, lenia);
+}
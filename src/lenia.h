@@ -0,0 +1,90 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _LENIA_H
+#define _LENIA_H
+
+#include "types.h"
+#include "fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LeniaParams describes continuous automaton:
+//   A' = clamp(A + dt * G(K * A), 0, 1)
+// where K is a radial ring kernel and G is a gaussian growth function.
+typedef struct {
+  // Kernel radius in cells.
+  u32 radius;
+  // Integration step.
+  f32 dt;
+  // Center and width of the growth function.
+  f32 mu;
+  f32 sigma;
+} LeniaParams;
+
+// Parameters of the Orbium from the original Lenia paper.
+#define LENIA_ORBIUM ((LeniaParams){ \
+  .radius = 13,                      \
+  .dt     = 0.1f,                    \
+  .mu     = 0.15f,                   \
+  .sigma  = 0.015f,                  \
+})
+
+// Lenia is a continuous state field on the torus, same as the Field.
+// Kernel convolution is computed in the frequency domain, so cost of the
+// update does not depend on the kernel radius.
+typedef struct {
+  // Size of the side of the field, must be a power of two.
+  u32 stride;
+  LeniaParams params;
+
+  // Current state of the field, values are in range [0, 1].
+  f32* current;
+  // Result of the kernel convolution.
+  f32* potential;
+  // Spectrum of the field.
+  Complex* spectrum;
+  // Spectrum of the kernel multiplied by the normalization factor of the
+  // inverse transform.
+  Complex* kernel;
+
+  FFT2D fft;
+} Lenia;
+
+void leniaInit(Lenia* lenia, u32 stride, LeniaParams params);
+void leniaFree(Lenia* lenia);
+
+// leniaCellSet sets value of the cell, coordinates are wrapped.
+void leniaCellSet(Lenia* lenia, i32 x, i32 y, f32 value);
+
+// leniaSeed fills square of the given size around (x, y) with random values.
+void leniaSeed(Lenia* lenia, i32 x, i32 y, u32 size);
+
+// leniaUpdate advances the field by single time step.
+void leniaUpdate(Lenia* lenia);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
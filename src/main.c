@@ -21,12 +21,32 @@
 
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <raylib.h>
 #include <raymath.h>
+#include <rlgl.h>
 
 #include "types.h"
+#include "bench.h"
+#include "colorlife.h"
 #include "debug.h"
+#include "field.h"
+#include "grayscott.h"
+#include "hashlife.h"
+#include "kociemba.h"
+#include "lenia.h"
+#include "margolus.h"
+#include "minimap.h"
+#include "packed.h"
+#include "pixels.h"
+#include "quicklife.h"
+#include "region.h"
+#include "rubik.h"
+#include "tiled.h"
+#include "vectors.h"
+#include "voxels.h"
+#include "workers.h"
 
 // Default window dimensions
 #define DEFAULT_WIDHT  1000
@@ -36,29 +56,24 @@ local bool isPowerOfTwo(u32 x) {
   return (x & (x - 1)) == 0;
 }
 
-local u8 lerpU8(u8 start, u8 end, f64 amount) {
-  u8 result = start + CAST(u8, (amount * (end - start)));
-  return result;
-}
-
 local f64 clamp(f64 val, f64 min, f64 max) {
   if (val > max) return max;
   if (val < min) return min;
   return val;
 }
 
-local i32 modi32(i32 a, i32 b) {
-  if (a < 0) {
-    return (b + a) % b;
-  }
-  return a % b;
+// lerpU8 interpolates between two bytes, descending ramps included, the
+// result is clamped before the conversion so it never leaves [0, 255].
+local u8 lerpU8(u8 start, u8 end, f64 amount) {
+  f64 value = start + amount * ((f64)end - (f64)start);
+  return CAST(u8, clamp(value, 0, 255));
 }
 
 local Color lerpColor2(f64 amount, Color start, Color end) {
   Color result = {
     .r = lerpU8(start.r, end.r, amount),
     .g = lerpU8(start.g, end.g, amount),
-    .b = lerpU8(start.g, end.b, amount),
+    .b = lerpU8(start.b, end.b, amount),
     .a = lerpU8(start.a, end.a, amount),
   };
   return result;
@@ -81,8 +96,237 @@ Vector2 textDrawf(f32 x, f32 y,
   return size;
 }
 
+// Colors of the faces of the Rubik's cube in the order of RubikFace.
+local const Color rubik_colors[6] = {
+  RED, ORANGE, WHITE, YELLOW, GREEN, BLUE,
+};
+
+// Duration of the animated quarter turn of the layer in seconds.
+#define RUBIK_TURN_SECONDS 0.15
+// Longest solution of the 3x3x3 cube and the file of the solver tables, the
+// file is used when the binary is built without the embedded tables.
+#define RUBIK_SOLUTION     22
+#define RUBIK_TABLES       "kociemba.tables"
+// Number of the cubes along the edge of the lattice of the vector
+// benchmark.
+#define BENCH_VECTORS_EDGE 64
+// Size of the field and number of the generations of the color life
+// benchmark.
+#define BENCH_COLOR_LIFE_SIZE        2048
+#define BENCH_COLOR_LIFE_GENERATIONS 64
+// Number of the facelets written between the checks of the render batch
+// limit.
+#define RUBIK_CHUNK 1024
+
+// CubeScene holds Rubik's cube and the layout of its cubies.
+typedef struct {
+  RubikCube rubik;
+  // Distance between the centers of the cubies, gap between the facelets
+  // and scale that spreads cubies apart.
+  f32 pitch;
+  f32 gap;
+  f32 scale;
+  // Centers of the facelets in halves of the pitch, they are scaled into
+  // the centers drawn in the frame.
+  Vectors lattice;
+  Vectors centers;
+
+  // Selected layer, it is turned by X, Y and Z.
+  u32 layer;
+  // Move that is animated and the time it started at.
+  bool turning;
+  RubikMove move;
+  f64 turn_started_at;
+  // Seed of the next scramble.
+  u64 seed;
+
+  // Solver of the 3x3x3 cube, tables are loaded on the first use. Moves of
+  // the solution are animated one by one.
+  Kociemba solver;
+  bool solver_ready;
+  u8 solution[KOCIEMBA_MAX_LENGTH];
+  u32 solution_length;
+  u32 solution_next;
+} CubeScene;
+
+// cubeInLayer reports whether the facelet belongs to the layer of the move.
+local bool cubeInLayer(CubeScene* scene, u32 facelet, RubikMove move) {
+  i32 position[3], normal[3];
+  rubikFaceletPlace(scene->rubik.size, facelet, position, normal);
+  return position[move.axis] == rubikCoordinate(scene->rubik.size, move.layer);
+}
+
+// cubeFacelets draws facelets as quads on the faces of their cubies, only
+// facelets of the moving layer when moving is set or only the rest.
+local void cubeFacelets(CubeScene* scene, bool moving) {
+  u32 size  = scene->rubik.size;
+  f32 half  = scene->pitch * 0.5f - scene->gap;
+  u32 count = 0;
+
+  for (u32 i = 0; i < 6 * size * size; i++) {
+    if (scene->turning ? cubeInLayer(scene, i, scene->move) != moving : moving) {
+      continue;
+    }
+
+    if ((count & (RUBIK_CHUNK - 1)) == 0) {
+      if (count > 0) {
+        rlEnd();
+      }
+      rlCheckRenderBatchLimit(4 * RUBIK_CHUNK);
+      rlBegin(RL_QUADS);
+    }
+    count++;
+
+    u32 face = i / (size * size);
+    u32 axis = face / 2;
+    u32 u    = (axis + 1) % 3;
+    u32 v    = (axis + 2) % 3;
+    f32 center[3] = { scene->centers.x[i], scene->centers.y[i], scene->centers.z[i] };
+
+    // Corners go counterclockwise when looking at the face from outside.
+    f32 corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    Color color = rubik_colors[scene->rubik.facelets[i]];
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    for (u32 c = 0; c < 4; c++) {
+      u32 corner = (face & 1) == 0 ? c : 3 - c;
+      f32 vertex[3];
+      vertex[axis] = center[axis];
+      vertex[u]    = center[u] + corners[corner][0] * half;
+      vertex[v]    = center[v] + corners[corner][1] * half;
+      rlVertex3f(vertex[0], vertex[1], vertex[2]);
+    }
+  }
+
+  if (count > 0) {
+    rlEnd();
+  }
+}
+
+// cubeBody draws body of the cubies of the layers [from, to) along the axis.
+local void cubeBody(CubeScene* scene, u32 axis, u32 from, u32 to) {
+  if (from >= to) {
+    return;
+  }
+
+  u32 size = scene->rubik.size;
+  f32 unit = scene->pitch * scene->scale;
+  f32 side = unit * size;
+  f32 center[3] = { 0 };
+  f32 extent[3] = { side, side, side };
+
+  center[axis] = (rubikCoordinate(size, from) + rubikCoordinate(size, to - 1)) * 0.25f * unit;
+  extent[axis] = (to - from) * unit;
+
+  Vector3 position = { center[0], center[1], center[2] };
+  Vector3 box      = { extent[0], extent[1], extent[2] };
+  DrawCubeV(position, Vector3Scale(box, 0.99f), DARKGRAY);
+}
+
+// cubeTurn starts animated turn of the selected layer.
+local void cubeTurn(CubeScene* scene, u32 axis, u32 turns) {
+  scene->turning = true;
+  scene->move    = (RubikMove){ .axis = axis, .turns = turns, .layer = scene->layer };
+  scene->turn_started_at = GetTime();
+}
+
+// cubeRender draws the cube, the moving layer is rotated by the angle of
+// the animation.
+local void cubeRender(CubeScene* scene) {
+  u32 size = scene->rubik.size;
+
+  f32 origin[3] = { 0 };
+  vectorsTransform(&scene->centers, &scene->lattice, scene->pitch * 0.5f * scene->scale, origin);
+
+  if (!scene->turning) {
+    cubeBody(scene, 0, 0, size);
+    cubeFacelets(scene, false);
+    return;
+  }
+
+  RubikMove move = scene->move;
+  f64 duration = RUBIK_TURN_SECONDS * (move.turns == 2 ? 2 : 1);
+  f64 progress = (GetTime() - scene->turn_started_at) / duration;
+  if (progress >= 1) {
+    rubikMove(&scene->rubik, move);
+    scene->turning = false;
+    cubeRender(scene);
+    return;
+  }
+
+  cubeBody(scene, move.axis, 0, move.layer);
+  cubeBody(scene, move.axis, move.layer + 1, size);
+  cubeFacelets(scene, false);
+
+  // Three quarter turns are animated as single turn in the other
+  // direction.
+  f32 angle = (move.turns == 3 ? -90.0f : 90.0f * move.turns) * progress;
+
+  rlPushMatrix();
+  rlRotatef(angle, move.axis == 0, move.axis == 1, move.axis == 2);
+  cubeBody(scene, move.axis, move.layer, move.layer + 1);
+  cubeFacelets(scene, true);
+  rlPopMatrix();
+}
+
+// cubeResize creates solved cube with the given number of cubies along the
+// edge.
+local void cubeResize(CubeScene* scene, u32 size) {
+  if (scene->rubik.facelets != NULL) {
+    rubikFree(&scene->rubik);
+    vectorsFree(&scene->lattice);
+    vectorsFree(&scene->centers);
+  }
+  rubikInit(&scene->rubik, size);
+
+  u32 count = 6 * size * size;
+  vectorsInit(&scene->lattice, count);
+  vectorsInit(&scene->centers, count);
+  for (u32 i = 0; i < count; i++) {
+    i32 position[3], normal[3];
+    rubikFaceletPlace(size, i, position, normal);
+    vectorsSet(&scene->lattice, i, position[0] + normal[0], position[1] + normal[1],
+        position[2] + normal[2]);
+  }
+
+  scene->pitch   = 6.0f / size;
+  scene->gap     = scene->pitch * 0.05f;
+  scene->layer   = min_value(scene->layer, size - 1);
+  scene->turning = false;
+  scene->solution_length = 0;
+}
+
+// cubeSolve finds solution of the 3x3x3 cube, its moves are animated.
+local void cubeSolve(CubeScene* scene) {
+  if (!scene->solver_ready) {
+    kociembaInit(&scene->solver, RUBIK_TABLES);
+    scene->solver_ready = true;
+  }
+
+  i32 length = kociembaSolve(&scene->solver, &scene->rubik, RUBIK_SOLUTION, scene->solution);
+  if (length > 0) {
+    // Solution is replayed on the copy before it is animated.
+    RubikCube check;
+    rubikInit(&check, 3);
+    memcpy(check.facelets, scene->rubik.facelets, 54);
+    for (i32 i = 0; i < length; i++) {
+      rubikMove(&check, kociembaMove(scene->solution[i]));
+    }
+    assertf(rubikSolved(&check), "Solution of %d moves does not solve the cube", length);
+    rubikFree(&check);
+  }
+
+  scene->solution_length = max_value(length, 0);
+  scene->solution_next   = 0;
+}
+
+// cube runs Rubik's cube simulator:
+//   O/L add or remove cubies along the edge, I/K spread cubies apart,
+//   Up/Down select layer, X/Y/Z turn selected layer around the axis,
+//   Shift turns it the other way, Space scrambles and Enter resets it. S
+//   solves 3x3x3 cube move by move.
 local i32 cube(void) {
-  InitWindow(DEFAULT_WIDHT, DEFALUT_HEIGHT, "3D Cube");
+  InitWindow(DEFAULT_WIDHT, DEFALUT_HEIGHT, "Rubik's cube");
+  workersInit(0);
 
   // Define the camera to look into our 3d world
   Camera3D camera = { 
@@ -93,29 +337,59 @@ local i32 cube(void) {
     .projection = CAMERA_PERSPECTIVE,
   };
 
-  f32 exterior_cube_side = 6.0f;
-  f32 gap_size           = 0.05f;
-  i32 cubes_per_edge     = 10;
-  f32 scale              = 1.0f;
+  CubeScene scene = { .scale = 1.0f, .seed = 1 };
+  cubeResize(&scene, 3);
 
   // Limit cursor to relative movement inside the window
   // DisableCursor();
   SetTargetFPS(60);
 
   while (!WindowShouldClose()) {
-    if (IsKeyPressed(KEY_O)) {
-      cubes_per_edge++;
-    } else if (cubes_per_edge > 1 && IsKeyPressed(KEY_L)) {
-      cubes_per_edge--;
+    u32 size = scene.rubik.size;
+    if (IsKeyPressed(KEY_O) && size < RUBIK_MAX_SIZE) {
+      cubeResize(&scene, size + 1);
+    } else if (size > 1 && IsKeyPressed(KEY_L)) {
+      cubeResize(&scene, size - 1);
     }
 
     if (IsKeyDown(KEY_I)) {
-      scale += 0.01;
-    } else if (scale > 1 && IsKeyDown(KEY_K)) {
-      scale -= 0.01;
+      scene.scale += 0.01;
+    } else if (scene.scale > 1 && IsKeyDown(KEY_K)) {
+      scene.scale -= 0.01;
     }
 
-    f32 interior_cube_size = (exterior_cube_side - (gap_size * (cubes_per_edge - 1))) / cubes_per_edge;
+    if (IsKeyPressed(KEY_UP) && scene.layer + 1 < scene.rubik.size) {
+      scene.layer++;
+    } else if (IsKeyPressed(KEY_DOWN) && scene.layer > 0) {
+      scene.layer--;
+    }
+
+    if (!scene.turning && scene.solution_next < scene.solution_length) {
+      RubikMove move = kociembaMove(scene.solution[scene.solution_next++]);
+      scene.layer = move.layer;
+      cubeTurn(&scene, move.axis, move.turns);
+    } else if (!scene.turning) {
+      u32 turns = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT) ? 3 : 1;
+      if (IsKeyPressed(KEY_X)) {
+        cubeTurn(&scene, 0, turns);
+      } else if (IsKeyPressed(KEY_Y)) {
+        cubeTurn(&scene, 1, turns);
+      } else if (IsKeyPressed(KEY_Z)) {
+        cubeTurn(&scene, 2, turns);
+      } else if (IsKeyPressed(KEY_SPACE)) {
+        u32 count = 20 * scene.rubik.size;
+        RubikMove* moves = gmalloc(count * sizeof(RubikMove));
+        rubikRandomMoves(scene.rubik.size, scene.seed++, moves, count);
+        for (u32 i = 0; i < count; i++) {
+          rubikMove(&scene.rubik, moves[i]);
+        }
+        gfree(moves);
+      } else if (IsKeyPressed(KEY_ENTER)) {
+        rubikReset(&scene.rubik);
+      } else if (IsKeyPressed(KEY_S) && scene.rubik.size == 3) {
+        cubeSolve(&scene);
+      }
+    }
 
     // TODO: would be better if camera was orbital, probably.
     UpdateCamera(&camera, CAMERA_ORBITAL);
@@ -125,53 +399,23 @@ local i32 cube(void) {
       ClearBackground(WHITE);
 
       BeginMode3D(camera);
-
-      f32 end   = exterior_cube_side * 0.5;
-      f32 start = -end;
-      assertf((start + end) == 0, "Expected to center on center");
-
-      f32 half_size = interior_cube_size * 0.5;
-      Vector3 cube_size = {
-        .x = interior_cube_size,
-        .y = interior_cube_size,
-        .z = interior_cube_size,
-      };
-
-      {
-        for (f32 z = start; z <= end; z += interior_cube_size + gap_size) {
-          for (f32 y = start; y <= end; y += interior_cube_size + gap_size) {
-            for (f32 x = start; x <= end; x += interior_cube_size + gap_size) {
-
-              Vector3 position = Vector3Scale(
-                  Vector3AddValue((Vector3){
-                    .x = x,
-                    .y = y,
-                    .z = z,
-                  }, half_size),
-                  scale
-              );
-
-              Vector3 norm = Vector3Normalize(position);
-              Color color = {
-                .r = lerpU8(20, 255, norm.x),
-                .g = lerpU8(20, 255, norm.y),
-                .b = lerpU8(20, 255, norm.z),
-                .a = 0xff,
-              };
-
-              DrawCubeV(position, cube_size, color);
-              // DrawCubeWiresV(position, cube_size, WHITE);
-            }
-          }
-        }
-
-      }
+      cubeRender(&scene);
       EndMode3D();
 
+      textDrawf(10, 10, GetFontDefault(), 20, 1, BLACK,
+        "SIZE: %u LAYER: %u %s", scene.rubik.size, scene.layer,
+        rubikSolved(&scene.rubik) ? "SOLVED" : "");
     }
     EndDrawing();
   }
 
+  rubikFree(&scene.rubik);
+  vectorsFree(&scene.lattice);
+  vectorsFree(&scene.centers);
+  if (scene.solver_ready) {
+    kociembaFree(&scene.solver);
+  }
+  workersClose();
   return 0;
 }
 
@@ -179,163 +423,738 @@ local i32 cube(void) {
 /// Game of life
 ////////////////////////////////////////////////////////////////////////////////
 
+// Engine selects automaton that is simulated by the game.
 typedef enum {
-  EMPTY  = 0,
-  DEAD   = 2,
-  DIYING = 3,
-  ALIVE  = 4,
-} State;
+  ENGINE_LIFE       = 0,
+  ENGINE_LENIA      = 1,
+  ENGINE_GRAY_SCOTT = 2,
+  ENGINE_MARGOLUS   = 3,
+  ENGINE_COLOR_LIFE = 4,
+  ENGINE_PACKED     = 5,
+  ENGINE_HASHLIFE   = 6,
+  ENGINE_QUICKLIFE  = 7,
+} Engine;
+
+// Number of colors in the ramp used for the continuous engines.
+#define RAMP_SIZE 256
 
-// Field represents playing field.
+// Game holds data necessary for the rendering
 typedef struct {
-  // Size of the side of the field
-  u32 stride;
-  // Current state of the field
-  u8* current;
-  // Temporary array that holds state of the cells for the next game tick.
-  u8* next;
-} Field;
+  // Field rectangle
+  Rectangle rect;
+  // Simulated automaton
+  Engine engine;
+  // Field, used by ENGINE_LIFE and ENGINE_MARGOLUS
+  Field field;
+  // Life stored in the tiles, used by ENGINE_LIFE with the tiled layout.
+  // The field holds copy of its cells for the rendering and the edits.
+  bool tiled;
+  TiledField tiled_field;
+  // Fork of the tiled life taken on K, it advances along with the life and
+  // L switches between them.
+  bool forked;
+  TiledField fork;
+  // Block rule of the ENGINE_MARGOLUS
+  const MargolusRule* block_rule;
+  // Multi-color life, used by ENGINE_COLOR_LIFE
+  ColorLife color_life;
+  // Life with two bits per cell, used by ENGINE_PACKED
+  PackedField packed;
+  // Decoded states of the cells in the view of the packed field.
+  u8* packed_states;
+  // Infinite life, used by ENGINE_HASHLIFE. The field holds its cells
+  // around the origin.
+  HashLife hashlife;
+  // Infinite life of the sleeping tiles, used by ENGINE_QUICKLIFE. The
+  // field holds its cells around the origin.
+  QuickLife quicklife;
+  // Continuous field, used by ENGINE_LENIA
+  Lenia lenia;
+  // Reaction-diffusion system, used by ENGINE_GRAY_SCOTT
+  GrayScott gray_scott;
+
+  // Continuous engines are rendered as a texture, cell values are mapped
+  // to the colors of the ramp.
+  Texture2D texture;
+  Color* pixels;
+  Color ramp[RAMP_SIZE];
+
+  // Engines with the cell states are rendered into the texture as well,
+  // states take the colors of the palette. In the heat map mode alive cells
+  // take colors of their ages from the ramp. Ages are kept for the cells
+  // in the view packed row after row, they start over when the view moves.
+  u32 palette[PIXELS_PALETTE];
+  u32 heat[PIXELS_HEAT];
+  u8* ages;
+  bool heatmap;
+
+  // Cells shown in the field rectangle, size of the field is 2^zoom times
+  // of the size of the view.
+  Region view;
+  u32 zoom;
+  // Overview of the whole field, shown while zoomed in.
+  Minimap minimap;
+  Texture2D minimap_texture;
 
-// fieldInit initializes field with given stride - field is always a square.
-local void fieldInit(Field* field, u32 stride) {
-  u32 size = stride * stride;
-  field->current = (u8*)calloc(size, sizeof(u8));
-  field->next    = (u8*)calloc(size, sizeof(u8));
-  field->stride  = stride;
+  bool selected;
+  // selected coordinates
+  i32 x;
+  i32 y;
+
+  // Region of the field selected with the right mouse button, the anchor
+  // is the cell where selection started.
+  bool has_region;
+  Region region;
+  i32 anchor_x;
+  i32 anchor_y;
+  // Cells copied from the selected region.
+  Pattern clipboard;
+
+  // Density and seed of the random soup, soup is regenerated with the next
+  // seed on G.
+  f64 density;
+  u64 seed;
+
+  // Pause is a flag that stops game ticks
+  bool pause;
+  // Number of seconds per single game tick
+  f64 seconds_per_tick;
+  // Time of the last tick
+  f64 last_tick_at;
+} Game;
+
+// gameRampInit fills color ramp by interpolating between evenly spaced stops.
+local void gameRampInit(Game* game, const Color* stops, u32 count) {
+  for (u32 i = 0; i < RAMP_SIZE; i++) {
+    f64 position = (f64)i / (RAMP_SIZE - 1) * (count - 1);
+    u32 stop     = min_value((u32)position, count - 2);
+    game->ramp[i] = lerpColor2(position - stop, stops[stop], stops[stop + 1]);
+  }
 }
 
-// fieldFree frees resouces allocated by the field.
-local void fieldFree(Field* field) {
-  free(field->current);
-  free(field->next);
+// gameTextureInit creates texture of the given size for the continuous engines.
+local void gameTextureInit(Game* game, u32 width, u32 height,
+    const Color* stops, u32 count) {
+  Image image   = GenImageColor(width, height, WHITE);
+  game->texture = LoadTextureFromImage(image);
+  game->pixels  = gcalloc((usize)width * height, sizeof(Color));
+  UnloadImage(image);
+
+  gameRampInit(game, stops, count);
 }
 
-// fieldCellIndex returns index of the cell in the array.
-local u32 fieldCellIndex(Field* field, i32 x, i32 y) {
-  x = modi32(x, field->stride);
-  y = modi32(y, field->stride);
+// gameStateColor returns color of the cell state of the life.
+local Color gameStateColor(State state) {
+  switch (state) {
+    case DEAD:
+      return Fade(ORANGE, 0.2);
+    case DIYING:
+      return ORANGE;
+    case ALIVE:
+      return RED;
+    default:
+      return WHITE;
+  }
+}
 
-  u32 idx = field->stride * y + x;
-  u32 len = field->stride * field->stride;
+// gameColorPixel returns color as the pixel of the texture.
+local u32 gameColorPixel(Color color) {
+  u32 pixel;
+  memcpy(&pixel, &color, sizeof(pixel));
+  return pixel;
+}
 
-  assertf(idx < len, "Index %u is out of bounds (length: %u)", idx, len);
+// gameCellsInit creates texture of the field rectangle size for the engines
+// with the cell states, ages of the cells come with the view.
+local void gameCellsInit(Game* game) {
+  Color stops[] = { RED, ORANGE, GOLD, YELLOW };
+  gameTextureInit(game, game->rect.width, game->rect.height, stops, 4);
 
-  return idx;
+  for (u32 i = 0; i < PIXELS_PALETTE; i++) {
+    game->palette[i] = gameColorPixel(gameStateColor(i));
+  }
+  for (u32 i = 0; i < PIXELS_HEAT; i++) {
+    game->heat[i] = gameColorPixel(game->ramp[i * RAMP_SIZE / PIXELS_HEAT]);
+  }
 }
 
-// fieldCellSet sets cell state.
-local void fieldCellSet(Field* field, i32 x, i32 y, State state) {
-  u32 idx = fieldCellIndex(field, x, y);
-  field->current[idx] = state;
+// gameMinimapInit creates minimap of the field with the cell states.
+local void gameMinimapInit(Game* game, u32 width, u32 height) {
+  u32 shades[MINIMAP_SHADES];
+  for (u32 i = 0; i < MINIMAP_SHADES; i++) {
+    Color color = lerpColor2((f64)i / (MINIMAP_SHADES - 1), RAYWHITE, MAROON);
+    shades[i]   = gameColorPixel(color);
+  }
+  minimapInit(&game->minimap, width, height, shades);
+
+  Image image = GenImageColor(game->minimap.columns, game->minimap.rows, WHITE);
+  game->minimap_texture = LoadTextureFromImage(image);
+  UnloadImage(image);
 }
 
-// fieldCellState returns cell state
-local State fieldCellState(Field* field, i32 x, i32 y) {
-  u32 idx = fieldCellIndex(field, x, y);
-  return field->current[idx];
+// gameCellsFree frees texture and ages of the cells.
+local void gameCellsFree(Game* game) {
+  UnloadTexture(game->texture);
+  gfree(game->pixels);
+  gfree(game->ages);
+  minimapFree(&game->minimap);
+  UnloadTexture(game->minimap_texture);
 }
 
-// fieldCellIsAlive checks if the cell at given coordinates is alive.
-local bool fieldCellIsAlive(Field* field, i32 x, i32 y) {
-  return fieldCellState(field, x, y) == ALIVE;
+// Colors of the species of the multi-color life.
+local const Color species_colors[COLOR_LIFE_MAX_SPECIES] = {
+  RED, BLUE, GREEN, GOLD,
+};
+
+// gameCreate creates new game with given field size and update speed.
+// Only life and Margolus fields may be rectangular, other engines use
+// square of the given width.
+local Game gameCreate(Rectangle rect, Engine engine, u32 width, u32 height,
+    f64 seconds_per_tick) {
+  u32 field_size = width;
+
+  Game game = {
+    .rect             = rect,
+    .engine           = engine,
+    .pause            = true,
+    .seconds_per_tick = seconds_per_tick,
+    .last_tick_at     = 0,
+  };
+
+  switch (engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+      fieldInit(&game.field, width, height);
+      gameCellsInit(&game);
+      gameMinimapInit(&game, width, height);
+      break;
+    case ENGINE_HASHLIFE:
+    case ENGINE_QUICKLIFE:
+      // Plane is created by the caller with the rule.
+      fieldInit(&game.field, width, height);
+      gameCellsInit(&game);
+      gameMinimapInit(&game, width, height);
+      break;
+    case ENGINE_LENIA: {
+      Color stops[] = { WHITE, ORANGE, RED, MAROON };
+      leniaInit(&game.lenia, field_size, LENIA_ORBIUM);
+      leniaSeed(&game.lenia, field_size / 2, field_size / 2, field_size / 4);
+      gameTextureInit(&game, field_size, field_size, stops, 4);
+    } break;
+    case ENGINE_GRAY_SCOTT: {
+      Color stops[] = { WHITE, SKYBLUE, BLUE, DARKBLUE };
+      grayScottInit(&game.gray_scott, field_size, GRAY_SCOTT_MITOSIS);
+      for (u32 i = 0; i < 16; i++) {
+        grayScottSeed(&game.gray_scott, rand() % field_size, rand() % field_size, 16);
+      }
+      gameTextureInit(&game, field_size, field_size, stops, 4);
+    } break;
+    case ENGINE_COLOR_LIFE:
+      // Number of species is set by the caller with gameSetSpecies.
+      break;
+    case ENGINE_PACKED:
+      packedFieldInit(&game.packed, width, height, RULE_LIFE);
+      gameCellsInit(&game);
+      gameMinimapInit(&game, width, height);
+      break;
+  }
+
+  return game;
 }
 
+// gameClose closes the game and frees allocated resources.
+local void gameClose(Game* game) {
+  game->pause = true;
 
-// fieldNext returns state of the cell at the next game tick.
-local State fieldNext(Field* field, i32 x, i32 y) {
-  u32 alive_neighbors = 0;
-  alive_neighbors += fieldCellIsAlive(field, x,     y + 1); // S
-  alive_neighbors += fieldCellIsAlive(field, x - 1, y + 1); // SW
-  alive_neighbors += fieldCellIsAlive(field, x - 1, y    ); // W
-  alive_neighbors += fieldCellIsAlive(field, x - 1, y - 1); // NW
-  alive_neighbors += fieldCellIsAlive(field, x,     y - 1); // N
-  alive_neighbors += fieldCellIsAlive(field, x + 1, y - 1); // NE
-  alive_neighbors += fieldCellIsAlive(field, x + 1, y    ); // E
-  alive_neighbors += fieldCellIsAlive(field, x + 1, y + 1); // SE
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+      if (game->tiled) {
+        tiledFieldFree(&game->tiled_field);
+      }
+      if (game->forked) {
+        tiledFieldFree(&game->fork);
+      }
+      fieldFree(&game->field);
+      patternFree(&game->clipboard);
+      gameCellsFree(game);
+      break;
+    case ENGINE_LENIA:
+      leniaFree(&game->lenia);
+      UnloadTexture(game->texture);
+      gfree(game->pixels);
+      break;
+    case ENGINE_GRAY_SCOTT:
+      grayScottFree(&game->gray_scott);
+      UnloadTexture(game->texture);
+      gfree(game->pixels);
+      break;
+    case ENGINE_COLOR_LIFE:
+      colorLifeFree(&game->color_life);
+      break;
+    case ENGINE_PACKED:
+      packedFieldFree(&game->packed);
+      gfree(game->packed_states);
+      gameCellsFree(game);
+      break;
+    case ENGINE_HASHLIFE:
+      hashlifeFree(&game->hashlife);
+      fieldFree(&game->field);
+      gameCellsFree(game);
+      break;
+    case ENGINE_QUICKLIFE:
+      quickLifeFree(&game->quicklife);
+      fieldFree(&game->field);
+      gameCellsFree(game);
+      break;
+  }
+}
 
-  State state = fieldCellState(field, x, y);
+// gameSetSpecies initializes multi-color life with given number of species
+// and fills it with random soup.
+local void gameSetSpecies(Game* game, u32 field_size, u32 species) {
+  colorLifeInit(&game->color_life, field_size, species);
+  for (u32 y = 0; y < field_size; y++) {
+    for (u32 x = 0; x < field_size; x++) {
+      if (rand() % 4 == 0) {
+        colorLifeCellSet(&game->color_life, x, y, 1 + rand() % species);
+      }
+    }
+  }
+}
 
-	// Alive when:
-	//   exactly 3 neighbors: on,
-	//   exactly 2 neighbors: maintain current state,
-  if (alive_neighbors == 3 || (alive_neighbors == 2 && state == ALIVE)) {
-    return ALIVE;
+// gameWidth returns number of columns of the simulated field.
+local u32 gameWidth(Game* game) {
+  switch (game->engine) {
+    case ENGINE_LENIA:
+      return game->lenia.stride;
+    case ENGINE_GRAY_SCOTT:
+      return game->gray_scott.stride;
+    case ENGINE_COLOR_LIFE:
+      return game->color_life.stride;
+    case ENGINE_PACKED:
+      return game->packed.width;
+    default:
+      return game->field.width;
   }
+}
 
-  switch (state) {
-    case ALIVE:
-      return DIYING;
-    case DIYING:
-      return DEAD;
-    case DEAD:
-      return DEAD;
+// gameHeight returns number of rows of the simulated field.
+local u32 gameHeight(Game* game) {
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+    case ENGINE_HASHLIFE:
+    case ENGINE_QUICKLIFE:
+      return game->field.height;
+    case ENGINE_PACKED:
+      return game->packed.height;
     default:
-      return EMPTY;
+      return gameWidth(game);
   }
 }
 
-// fieldUpdate updates current state of the field.
-local void fieldUpdate(Field* field) {
-  // @slow: I am not sure but it seems like it would be faster to work
-  //  with the array directly rather then converting x and y coordinates
-  //  to the index.
-  //  At least iteration through the array is somewhat sequential, probably
-  //  will not be predicted correctly because of fieldNext function that
-  //  accessing cells out of the order.
-  for (u32 y = 0; y < field->stride; y++) {
-    for (u32 x = 0; x < field->stride; x++) {
-      u32 index = fieldCellIndex(field, x, y);
-      field->next[index] = fieldNext(field, x, y);
+// gameIsHex reports whether cells of the game are laid out on the hexagonal
+// grid.
+local bool gameIsHex(Game* game) {
+  return game->engine == ENGINE_LIFE
+    && game->field.neighborhood == NEIGHBORHOOD_HEX;
+}
+
+// gameHasCells reports whether the engine has cell states, they are
+// rendered with the zoom and the minimap.
+local bool gameHasCells(Game* game) {
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+    case ENGINE_PACKED:
+    case ENGINE_HASHLIFE:
+    case ENGINE_QUICKLIFE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// gameViewCells keeps buffers of the cells in the view in step with the
+// view: they follow its size and ages start over once it moves.
+local void gameViewCells(Game* game, Region previous) {
+  usize size = (usize)game->view.width * game->view.height;
+  if (game->ages != NULL && (usize)previous.width * previous.height == size) {
+    if (previous.x != game->view.x || previous.y != game->view.y) {
+      memset(game->ages, 0, size);
     }
+    return;
   }
 
-  usize size = (field->stride * field->stride) * sizeof(bool);
+  if (game->ages != NULL) {
+    gfree(game->ages);
+  }
+  game->ages = gcalloc(size, sizeof(u8));
+  if (game->engine == ENGINE_PACKED) {
+    if (game->packed_states != NULL) {
+      gfree(game->packed_states);
+    }
+    game->packed_states = gmalloc(size);
+  }
+}
 
-  // Updating current state of the field
-  memcpy(field->current, field->next, size);
+// gameViewAt sets view of the current zoom, so the cell (x, y) is at the
+// given fractions of the view width and height. View stays inside the
+// field.
+local void gameViewAt(Game* game, i32 x, i32 y, f32 fx, f32 fy) {
+  u32 width  = gameWidth(game);
+  u32 height = gameHeight(game);
+
+  Region previous = game->view;
+  game->view.width  = width >> game->zoom;
+  game->view.height = height >> game->zoom;
+  game->view.x = clamp(x - (i32)(fx * game->view.width), 0, width - game->view.width);
+  game->view.y = clamp(y - (i32)(fy * game->view.height), 0, height - game->view.height);
+
+  if (gameHasCells(game)) {
+    gameViewCells(game, previous);
+  }
 }
 
-local i32 randomi32(i32 min, i32 max) {
-  return rand() % (max + 1 - min) + min;
+// gameZoom changes zoom keeping the cell (x, y) at the same place of the
+// view. View is at least 4 cells wide and high.
+local void gameZoom(Game* game, u32 zoom, i32 x, i32 y) {
+  if ((gameWidth(game) >> zoom) < 4 || (gameHeight(game) >> zoom) < 4) {
+    return;
+  }
+
+  f32 fx = (f32)(x - game->view.x) / game->view.width;
+  f32 fy = (f32)(y - game->view.y) / game->view.height;
+  game->zoom = zoom;
+  gameViewAt(game, x, y, fx, fy);
 }
 
-// Game holds data necessary for the rendering
-typedef struct {
-  // Field rectangle
-  Rectangle rect;
-  // Field
-  Field field;
+// gameCellSize returns size of the cell on the screen. Odd rows of the
+// hexagonal grid are shifted by half of the cell, so the row holds one half
+// more of the cell.
+local Vector2 gameCellSize(Game* game) {
+  f32 columns = game->view.width + (gameIsHex(game) ? 0.5f : 0.0f);
+  Vector2 size = {
+    .x = game->rect.width  / columns,
+    .y = game->rect.height / game->view.height,
+  };
+  return size;
+}
 
-  bool selected;
-  // selected coordinates
-  i32 x;
-  i32 y;
+// gameCellAt returns coordinates of the cell under the point of the field
+// rectangle.
+local void gameCellAt(Game* game, Vector2 pos, i32* x, i32* y) {
+  Vector2 cell = gameCellSize(game);
 
-  // Pause is a flag that stops game ticks
-  bool pause;
-  // Number of seconds per single game tick
-  f64 seconds_per_tick;
-  // Time of the last tick
-  f64 last_tick_at;
-} Game;
+  *y = game->view.y + (i32)clamp((pos.y - game->rect.y) / cell.y,
+      0, game->view.height - 1);
+  f32 shift = (gameIsHex(game) && (*y & 1)) ? cell.x * 0.5f : 0.0f;
+  *x = game->view.x + (i32)clamp((pos.x - game->rect.x - shift) / cell.x,
+      0, game->view.width - 1);
+}
 
-// gameCreate creates new game with given field size and update speed
-local Game gameCreate(Rectangle rect, u32 field_size, f64 seconds_per_tick) {
-  Game game = {
-    .rect             = rect,
-    .pause            = true,
-    .seconds_per_tick = seconds_per_tick,
-    .last_tick_at     = 0,
+// Largest side of the minimap on the screen.
+#define MINIMAP_SCREEN 160
+
+// gameMinimapRect returns rectangle of the minimap in the top right corner
+// of the screen.
+local Rectangle gameMinimapRect(Game* game) {
+  Minimap* map = &game->minimap;
+  f32 scale    = (f32)MINIMAP_SCREEN / max_value(map->columns, map->rows);
+
+  Rectangle rect = {
+    .x      = GetScreenWidth() - 10 - map->columns * scale,
+    .y      = 10,
+    .width  = map->columns * scale,
+    .height = map->rows * scale,
   };
-  fieldInit(&game.field, field_size);
+  return rect;
+}
 
-  return game;
+// gameEdit applies user click to the cell at given coordinates.
+local void gameEdit(Game* game, i32 x, i32 y) {
+  minimapMark(&game->minimap, x, y, 1, 1);
+
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS: {
+      State state = fieldCellIsAlive(&game->field, x, y) ? DEAD : ALIVE;
+      fieldCellSet(&game->field, x, y, state);
+      if (game->tiled) {
+        tiledFieldCellSet(&game->tiled_field, x, y, state);
+      }
+    } break;
+    case ENGINE_PACKED: {
+      bool alive = packedFieldCellState(&game->packed, x, y) == ALIVE;
+      packedFieldCellSet(&game->packed, x, y, alive ? DEAD : ALIVE);
+    } break;
+    case ENGINE_HASHLIFE: {
+      i64 hx = x - (i64)game->field.width / 2;
+      i64 hy = y - (i64)game->field.height / 2;
+      bool alive = hashlifeCellState(&game->hashlife, hx, hy) == ALIVE;
+      hashlifeCellSet(&game->hashlife, hx, hy, !alive);
+      fieldCellSet(&game->field, x, y, alive ? EMPTY : ALIVE);
+    } break;
+    case ENGINE_QUICKLIFE: {
+      i64 qx = x - (i64)game->field.width / 2;
+      i64 qy = y - (i64)game->field.height / 2;
+      bool alive = quickLifeCellState(&game->quicklife, qx, qy) == ALIVE;
+      quickLifeCellSet(&game->quicklife, qx, qy, !alive);
+      fieldCellSet(&game->field, x, y, alive ? EMPTY : ALIVE);
+    } break;
+    case ENGINE_LENIA:
+      leniaSeed(&game->lenia, x, y, game->lenia.params.radius * 2);
+      break;
+    case ENGINE_GRAY_SCOTT:
+      grayScottSeed(&game->gray_scott, x, y, 16);
+      break;
+    case ENGINE_COLOR_LIFE: {
+      // Clicks cycle cell through the colors of all species.
+      ColorLife* life = &game->color_life;
+      u32 cell = colorLifeCell(life, x, y);
+      colorLifeCellSet(life, x, y, (cell + 1) % (life->species + 1));
+    } break;
+  }
 }
 
-// gameClose closes the game and frees allocated resources.
-local void gameClose(Game* game) {
-  game->pause = true;
-  fieldFree(&game->field);
+// gameSelect extends selected region from the anchor to the cell.
+local void gameSelect(Game* game, i32 x, i32 y) {
+  game->has_region = true;
+  game->region = (Region){
+    .x      = min_value(game->anchor_x, x),
+    .y      = min_value(game->anchor_y, y),
+    .width  = abs(x - game->anchor_x) + 1,
+    .height = abs(y - game->anchor_y) + 1,
+  };
+}
+
+// gameTiledSync copies cells of the life field edited as a whole into its
+// tiles.
+local void gameTiledSync(Game* game) {
+  if (game->tiled) {
+    tiledFieldFromField(&game->tiled_field, &game->field);
+  }
+}
+
+// gameSoup fills the field with random soup of the current density and
+// seed.
+local void gameSoup(Game* game) {
+  minimapMarkAll(&game->minimap);
+
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+      fieldRandomize(&game->field, game->density, game->seed);
+      gameTiledSync(game);
+      break;
+    case ENGINE_PACKED:
+      packedFieldRandomize(&game->packed, game->density, game->seed);
+      break;
+    case ENGINE_HASHLIFE:
+      fieldRandomize(&game->field, game->density, game->seed);
+      hashlifeFromField(&game->hashlife, &game->field);
+      break;
+    case ENGINE_QUICKLIFE:
+      fieldRandomize(&game->field, game->density, game->seed);
+      quickLifeFromField(&game->quicklife, &game->field);
+      break;
+    default:
+      break;
+  }
+}
+
+// gameRegionKeys applies region operations bound to the keys:
+//   G new random soup, C copy, X clear, F fill with random cells, V/B/N
+//   paste at the cursor overwriting, adding or toggling cells, R rotate and
+//   H/J flip clipboard horizontally/vertically.
+local void gameRegionKeys(Game* game) {
+  if (IsKeyPressed(KEY_G)) {
+    game->seed++;
+    gameSoup(game);
+  }
+
+  if (game->engine != ENGINE_LIFE && game->engine != ENGINE_MARGOLUS) {
+    return;
+  }
+
+  Field* field = &game->field;
+
+  if (game->has_region) {
+    if (IsKeyPressed(KEY_C)) {
+      patternFree(&game->clipboard);
+      regionCopy(field, game->region, &game->clipboard);
+    } else if (IsKeyPressed(KEY_X)) {
+      regionClear(field, game->region);
+      minimapMark(&game->minimap, game->region.x, game->region.y,
+          game->region.width, game->region.height);
+      gameTiledSync(game);
+    } else if (IsKeyPressed(KEY_F)) {
+      regionFill(field, game->region, game->density, ++game->seed);
+      minimapMark(&game->minimap, game->region.x, game->region.y,
+          game->region.width, game->region.height);
+      gameTiledSync(game);
+    }
+  }
+
+  if (game->clipboard.cells == NULL) {
+    return;
+  }
+
+  if (IsKeyPressed(KEY_V)) {
+    regionPaste(field, &game->clipboard, game->x, game->y, PASTE_OVERWRITE);
+    minimapMarkAll(&game->minimap);
+    gameTiledSync(game);
+  } else if (IsKeyPressed(KEY_B)) {
+    regionPaste(field, &game->clipboard, game->x, game->y, PASTE_OR);
+    minimapMarkAll(&game->minimap);
+    gameTiledSync(game);
+  } else if (IsKeyPressed(KEY_N)) {
+    regionPaste(field, &game->clipboard, game->x, game->y, PASTE_XOR);
+    minimapMarkAll(&game->minimap);
+    gameTiledSync(game);
+  } else if (IsKeyPressed(KEY_R)) {
+    patternRotate(&game->clipboard);
+  } else if (IsKeyPressed(KEY_H)) {
+    patternFlip(&game->clipboard, true);
+  } else if (IsKeyPressed(KEY_J)) {
+    patternFlip(&game->clipboard, false);
+  }
+}
+
+local void gameDecodeRows(void* ctx, u32 begin, u32 end) {
+  Game* game  = ctx;
+  Region view = game->view;
+  for (u32 y = begin; y < end; y++) {
+    packedFieldDecodeRow(&game->packed, view.y + y, view.x, view.width,
+        game->packed_states + (usize)y * view.width);
+  }
+}
+
+// gameCellStates returns states of the cells in the view of the engines
+// with the cell states and distance between their rows, or NULL for the
+// other engines. Packed field decodes only the rows of the view.
+local const u8* gameCellStates(Game* game, u32* pitch) {
+  Region view = game->view;
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+    case ENGINE_HASHLIFE:
+    case ENGINE_QUICKLIFE:
+      *pitch = game->field.pitch;
+      return game->field.current + (usize)view.y * game->field.pitch + view.x;
+    case ENGINE_PACKED:
+      workersRun(view.height, gameDecodeRows, game);
+      *pitch = view.width;
+      return game->packed_states;
+    default:
+      return NULL;
+  }
+}
+
+// gameMinimapMarkRows marks tiles of the minimap under the runs of the
+// changed rows.
+local void gameMinimapMarkRows(Minimap* map, const u8* changed, u32 width, u32 height) {
+  for (u32 y = 0; y < height;) {
+    if (!changed[y]) {
+      y++;
+      continue;
+    }
+    u32 end = y + 1;
+    while (end < height && changed[end]) {
+      end++;
+    }
+    minimapMark(map, 0, y, width, end - y);
+    y = end;
+  }
+}
+
+// gameMinimapMark marks tiles of the minimap under the cells changed by the
+// last step: changed rows of the field and of the packed field and changed
+// tiles of the quicklife.
+local void gameMinimapMark(Game* game) {
+  Minimap* map = &game->minimap;
+  Field* field = &game->field;
+
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+    case ENGINE_HASHLIFE:
+      gameMinimapMarkRows(map, field->changed, field->width, field->height);
+      break;
+    case ENGINE_PACKED:
+      gameMinimapMarkRows(map, game->packed.changed, game->packed.width, game->packed.height);
+      break;
+    case ENGINE_QUICKLIFE: {
+      // Field shows the plane with the origin in its center.
+      QuickLife* life = &game->quicklife;
+      for (u32 i = 0; i < life->dirty_count; i++) {
+        const QuickTile* tile = &life->tiles[life->dirty[i]];
+        minimapMark(map,
+            (i64)tile->x * QUICKLIFE_TILE + field->width / 2,
+            (i64)tile->y * QUICKLIFE_TILE + field->height / 2,
+            QUICKLIFE_TILE, QUICKLIFE_TILE);
+      }
+    } break;
+    default:
+      minimapMarkAll(map);
+      break;
+  }
+}
+
+// gameStep advances simulated automaton by single tick.
+local void gameStep(Game* game) {
+  switch (game->engine) {
+    case ENGINE_LIFE:
+      if (game->tiled) {
+        tiledFieldUpdate(&game->tiled_field);
+        tiledFieldToField(&game->tiled_field, &game->field);
+        if (game->forked) {
+          tiledFieldUpdate(&game->fork);
+        }
+      } else {
+        fieldUpdate(&game->field);
+      }
+      break;
+    case ENGINE_MARGOLUS:
+      margolusUpdate(&game->field, game->block_rule);
+      break;
+    case ENGINE_LENIA:
+      leniaUpdate(&game->lenia);
+      break;
+    case ENGINE_GRAY_SCOTT:
+      grayScottUpdate(&game->gray_scott);
+      break;
+    case ENGINE_COLOR_LIFE:
+      colorLifeUpdate(&game->color_life);
+      break;
+    case ENGINE_PACKED:
+      packedFieldUpdate(&game->packed);
+      break;
+    case ENGINE_HASHLIFE:
+      if (!hashlifeStep(&game->hashlife)) {
+        // Universe is left as is, the game stops instead.
+        fprintf(stderr, "Hashlife universe cannot grow past 2^%u cells, paused\n",
+            HASHLIFE_MAX_LEVEL);
+        game->pause = true;
+        return;
+      }
+      hashlifeToField(&game->hashlife, &game->field,
+          -(i64)game->field.width / 2, -(i64)game->field.height / 2);
+      break;
+    case ENGINE_QUICKLIFE:
+      quickLifeStep(&game->quicklife);
+      quickLifeToField(&game->quicklife, &game->field,
+          -(i64)game->field.width / 2, -(i64)game->field.height / 2);
+      break;
+  }
+
+  u32 pitch = 0;
+  const u8* states = gameCellStates(game, &pitch);
+  if (states != NULL) {
+    pixelsAge(game->ages, states, pitch, game->view.width, game->view.height, ALIVE);
+    gameMinimapMark(game);
+  }
 }
 
 // gameUpdate updates game state form the user inputs as well as from ticks
@@ -345,6 +1164,27 @@ local void gameUpdate(Game* game) {
     game->pause = !game->pause;
   }
 
+  // Toggle heat map of the cell ages on T.
+  if (IsKeyPressed(KEY_T)) {
+    game->heatmap = !game->heatmap;
+  }
+
+  // Fork the tiled life on K, the fork shares tiles with the life until
+  // either of them changes. Switch between the life and the fork on L.
+  if (game->tiled && IsKeyPressed(KEY_K)) {
+    if (game->forked) {
+      tiledFieldFree(&game->fork);
+    }
+    tiledFieldFork(&game->fork, &game->tiled_field);
+    game->forked = true;
+  } else if (game->forked && IsKeyPressed(KEY_L)) {
+    TiledField tmp    = game->tiled_field;
+    game->tiled_field = game->fork;
+    game->fork        = tmp;
+    tiledFieldToField(&game->tiled_field, &game->field);
+    minimapMarkAll(&game->minimap);
+  }
+
   f64 spt = game->seconds_per_tick;
   if (IsKeyDown(KEY_W)) {
     spt -= 0.01;
@@ -356,95 +1196,384 @@ local void gameUpdate(Game* game) {
     game->seconds_per_tick = spt;
   }
 
+  Vector2 pos = GetMousePosition();
+  bool on_field = CheckCollisionPointRec(pos, game->rect);
+
+  // Mouse wheel zooms cells with the states around the cursor.
+  f32 wheel = GetMouseWheelMove();
+  if (wheel != 0 && on_field && gameHasCells(game)) {
+    i32 x, y;
+    gameCellAt(game, pos, &x, &y);
+    if (wheel > 0) {
+      gameZoom(game, game->zoom + 1, x, y);
+    } else if (game->zoom > 0) {
+      gameZoom(game, game->zoom - 1, x, y);
+    }
+  }
 
-  if (game->pause) {
-    Vector2 pos = GetMousePosition();
-    if (CheckCollisionPointRec(pos, game->rect)) {
-      f32 cell_width  = game->rect.width  / game->field.stride;
-      f32 cell_height = game->rect.height / game->field.stride;
+  // Minimap is shown while zoomed in, clicks on it center the view and
+  // are not passed to the field.
+  if (game->zoom > 0 && CheckCollisionPointRec(pos, gameMinimapRect(game))) {
+    on_field = false;
+    if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+      Rectangle map = gameMinimapRect(game);
+      f32 scale     = map.width / (game->minimap.columns * game->minimap.tile);
+      gameViewAt(game, (pos.x - map.x) / scale, (pos.y - map.y) / scale, 0.5f, 0.5f);
+    }
+  }
 
-      i32 x = (pos.x - game->rect.x) / cell_width;
-      i32 y = (pos.y - game->rect.y) / cell_height;
+  if (game->pause) {
+    if (on_field) {
+      i32 x, y;
+      gameCellAt(game, pos, &x, &y);
 
       if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        bool alive = fieldCellIsAlive(&game->field, x, y);
-        fieldCellSet(&game->field, x, y, alive ? DEAD : ALIVE);
+        gameEdit(game, x, y);
       } else {
         game->x = x;
         game->y = y;
       }
 
+      if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
+        game->anchor_x = x;
+        game->anchor_y = y;
+        gameSelect(game, x, y);
+      } else if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON)) {
+        gameSelect(game, x, y);
+      }
+
       game->selected = true;
     }
+
+    gameRegionKeys(game);
   } else {
     game->selected = false;
   }
 
   f64 time = GetTime();
   if (!game->pause && (time - game->last_tick_at) > game->seconds_per_tick) {
-    fieldUpdate(&game->field);
+    gameStep(game);
     game->last_tick_at = time;
   }
 }
 
-local void gameRenderCell(Game* game, i32 x, i32 y, Color color) {
-  x = modi32(x, game->field.stride);
-  y = modi32(y, game->field.stride);
+// gameCellRect returns rectangle of the cell on the screen.
+local Rectangle gameCellRect(Game* game, i32 x, i32 y) {
+  x = modi32(x, gameWidth(game));
+  y = modi32(y, gameHeight(game));
 
-  f32 cell_width  = game->rect.width  / game->field.stride;
-  f32 cell_height = game->rect.height / game->field.stride;
+  Vector2 cell = gameCellSize(game);
+  f32 shift    = (gameIsHex(game) && (y & 1)) ? cell.x * 0.5f : 0.0f;
 
   Rectangle rect = {
-    .x      = game->rect.x + (cell_width * x),
-    .y      = game->rect.y + (cell_height * y),
-    .width  = cell_width,
-    .height = cell_height,
+    .x      = game->rect.x + cell.x * (x - game->view.x) + shift,
+    .y      = game->rect.y + cell.y * (y - game->view.y),
+    .width  = cell.x,
+    .height = cell.y,
   };
+  return rect;
+}
+
+// gameHexRadius returns radius of the hexagon that fits into the cell.
+local f32 gameHexRadius(Rectangle rect) {
+  return min_value(rect.width / 1.7320508f, rect.height / 1.5f);
+}
+
+local void gameRenderCell(Game* game, i32 x, i32 y, Color color) {
+  Rectangle rect = gameCellRect(game, x, y);
+
+  if (gameIsHex(game)) {
+    Vector2 center = {
+      .x = rect.x + rect.width * 0.5f,
+      .y = rect.y + rect.height * 0.5f,
+    };
+    DrawPoly(center, 6, gameHexRadius(rect), 30, color);
+    return;
+  }
 
   DrawRectangleRec(rect, color);
 }
 
 local void gameRenderCellLines(Game* game, i32 x, i32 y, f32 thick, Color color) {
-  x = modi32(x, game->field.stride);
-  y = modi32(y, game->field.stride);
+  Rectangle rect = gameCellRect(game, x, y);
+
+  if (gameIsHex(game)) {
+    Vector2 center = {
+      .x = rect.x + rect.width * 0.5f,
+      .y = rect.y + rect.height * 0.5f,
+    };
+    DrawPolyLinesEx(center, 6, gameHexRadius(rect), 30, thick, color);
+    return;
+  }
+
+  DrawRectangleLinesEx(rect, thick, color);
+}
 
-  f32 cell_width  = game->rect.width  / game->field.stride;
-  f32 cell_height = game->rect.height / game->field.stride;
+typedef struct {
+  Game*      game;
+  const f32* values;
+  // Value that is mapped to the last color of the ramp.
+  f32        max;
+} GamePixelsJob;
+
+// gamePixels maps values of the rows in range to the ramp colors.
+local void gamePixels(void* ctx, u32 begin, u32 end) {
+  GamePixelsJob* job = ctx;
+  Game* game = job->game;
+  f32 scale  = (RAMP_SIZE - 1) / job->max;
+  usize from = (usize)begin * game->texture.width;
+  usize to   = (usize)end * game->texture.width;
+
+  for (usize i = from; i < to; i++) {
+    f32 index = clamp(job->values[i] * scale, 0, RAMP_SIZE - 1);
+    game->pixels[i] = game->ramp[(u32)index];
+  }
+}
 
-  Rectangle rect = {
-    .x      = game->rect.x + (cell_width * x),
-    .y      = game->rect.y + (cell_height * y),
-    .width  = cell_width,
-    .height = cell_height,
+// gameDrawTexture uploads pixels and draws them over the field rectangle.
+local void gameDrawTexture(Game* game) {
+  UpdateTexture(game->texture, game->pixels);
+
+  Rectangle source = {
+    .x      = 0,
+    .y      = 0,
+    .width  = game->texture.width,
+    .height = game->texture.height,
   };
+  DrawTexturePro(game->texture, source, game->rect, (Vector2){ 0 }, 0, WHITE);
+}
 
-  DrawRectangleLinesEx(rect, thick, color);
+// gameRenderTexture maps values to colors and draws them.
+local void gameRenderTexture(Game* game, const f32* values, f32 max) {
+  GamePixelsJob job = { .game = game, .values = values, .max = max };
+  workersRun(game->texture.height, gamePixels, &job);
+  gameDrawTexture(game);
 }
 
-// gameRender renders game field and updates game state if necessary
-local void gameRender(Game* game) {
+// gameRenderField renders cells of the game of life one by one, used for
+// the hexagonal grid.
+local void gameRenderField(Game* game) {
+  Region view = game->view;
+  for (u32 y = view.y; y < view.y + view.height; y++) {
+    for (u32 x = view.x; x < view.x + view.width; x++) {
+      gameRenderCell(game, x, y, gameStateColor(fieldCellState(&game->field, x, y)));
+    }
+  }
+}
+
+// Number of the quads written between the checks of the render batch limit.
+#define QUADS_CHUNK 1024
+
+// GameQuads writes colored rectangles into the render batch of rlgl, all of
+// them are drawn with the single draw call unless the batch overflows.
+typedef struct {
+  u32 count;
+} GameQuads;
+
+local void gameQuad(GameQuads* quads, Rectangle rect, Color color) {
+  if (quads->count == QUADS_CHUNK) {
+    rlEnd();
+    quads->count = 0;
+  }
+  if (quads->count == 0) {
+    rlCheckRenderBatchLimit(4 * QUADS_CHUNK);
+    rlBegin(RL_QUADS);
+  }
+  quads->count++;
+
+  rlColor4ub(color.r, color.g, color.b, color.a);
+  rlVertex2f(rect.x, rect.y);
+  rlVertex2f(rect.x, rect.y + rect.height);
+  rlVertex2f(rect.x + rect.width, rect.y + rect.height);
+  rlVertex2f(rect.x + rect.width, rect.y);
+}
+
+local void gameQuadsEnd(GameQuads* quads) {
+  if (quads->count > 0) {
+    rlEnd();
+  }
+  quads->count = 0;
+}
+
+// gameQuadKey returns key of the color of the cell, cells with the age are
+// keyed by the age above the states.
+local inline u32 gameQuadKey(const u8* states, const u8* ages, u32 x) {
+  return ages != NULL && ages[x] != 0 ? 256 + ages[x] : states[x];
+}
 
-  for (u32 y = 0; y < game->field.stride; y++) {
-    for (u32 x = 0; x < game->field.stride; x++) {
-      Color color;
-      switch (fieldCellState(&game->field, x, y)) {
-        case EMPTY:
-          color = WHITE;
-          break;
-        case DEAD:
-          color = Fade(ORANGE, 0.2);
-          break;
-        case DIYING:
-          color = ORANGE;
-          break;
-        case ALIVE:
-          color = RED;
-          break;
+// gameRenderQuads renders cells as quads, runs of the cells of the same
+// color make single quad and empty cells are skipped since they have the
+// color of the background. Grid lines are added on top of the cells.
+// States and ages start at the first cell of the view, ages are packed row
+// after row.
+local void gameRenderQuads(Game* game, const u8* states, const u8* ages, u32 pitch) {
+  u32 width    = game->view.width;
+  u32 height   = game->view.height;
+  Vector2 cell = gameCellSize(game);
+
+  GameQuads quads = { 0 };
+  for (u32 y = 0; y < height; y++) {
+    const u8* row     = states + (usize)y * pitch;
+    const u8* row_age = ages != NULL ? ages + (usize)y * width : NULL;
+
+    u32 x = 0;
+    while (x < width) {
+      u32 key = gameQuadKey(row, row_age, x);
+      u32 end = x + 1;
+      while (end < width && gameQuadKey(row, row_age, end) == key) {
+        end++;
       }
-      gameRenderCell(game, x, y, color);
+
+      if (key != EMPTY) {
+        Rectangle rect = {
+          .x      = game->rect.x + cell.x * x,
+          .y      = game->rect.y + cell.y * y,
+          .width  = cell.x * (end - x),
+          .height = cell.y,
+        };
+        Color color = key >= 256
+          ? game->ramp[(key - 256) * RAMP_SIZE / PIXELS_HEAT]
+          : gameStateColor(key);
+        gameQuad(&quads, rect, color);
+      }
+      x = end;
     }
   }
 
+  Color grid = Fade(LIGHTGRAY, 0.5);
+  for (u32 x = 0; x <= width; x++) {
+    Rectangle line = {
+      .x      = game->rect.x + cell.x * x,
+      .y      = game->rect.y,
+      .width  = 1,
+      .height = game->rect.height,
+    };
+    gameQuad(&quads, line, grid);
+  }
+  for (u32 y = 0; y <= height; y++) {
+    Rectangle line = {
+      .x      = game->rect.x,
+      .y      = game->rect.y + cell.y * y,
+      .width  = game->rect.width,
+      .height = 1,
+    };
+    gameQuad(&quads, line, grid);
+  }
+  gameQuadsEnd(&quads);
+}
+
+// gameRenderCells draws cell states over the field rectangle. Cells that
+// are large enough to have grid lines are drawn as quads, the others are
+// converted into the pixels of the texture.
+local void gameRenderCells(Game* game) {
+  u32 pitch = 0;
+  const u8* states = gameCellStates(game, &pitch);
+  const u8* ages   = game->heatmap ? game->ages : NULL;
+
+  if (gameCellSize(game).x >= PIXELS_GRID) {
+    gameRenderQuads(game, states, ages, pitch);
+    return;
+  }
+
+  PixelsView view = {
+    .states        = states,
+    .pitch         = pitch,
+    .width         = game->view.width,
+    .height        = game->view.height,
+    .ages          = ages,
+    .palette       = game->palette,
+    .heat          = game->heat,
+    .grid          = gameColorPixel(Fade(LIGHTGRAY, 0.5)),
+    .pixels        = (u32*)game->pixels,
+    .pixels_width  = game->texture.width,
+    .pixels_height = game->texture.height,
+  };
+  pixelsRender(&view);
+  gameDrawTexture(game);
+}
+
+// gameRenderColorLife renders live cells with the colors of their species.
+local void gameRenderColorLife(Game* game) {
+  ColorLife* life = &game->color_life;
+  GameQuads quads = { 0 };
+  for (u32 y = 0; y < life->stride; y++) {
+    for (u32 x = 0; x < life->stride; x++) {
+      u32 cell = colorLifeCell(life, x, y);
+      if (cell != 0) {
+        gameQuad(&quads, gameCellRect(game, x, y), species_colors[cell - 1]);
+      }
+    }
+  }
+  gameQuadsEnd(&quads);
+}
+
+// gameRenderMinimap updates minimap from the changed cells and renders it
+// with the outline of the view.
+local void gameRenderMinimap(Game* game) {
+  Minimap* map = &game->minimap;
+  if (map->stale_count > 0 && game->engine == ENGINE_PACKED) {
+    // Alive cells are set in both planes of the packed field.
+    PackedField* packed = &game->packed;
+    minimapUpdatePlanes(map, packed->high, packed->low, packed->words);
+  } else if (map->stale_count > 0) {
+    minimapUpdate(map, game->field.current, game->field.pitch, ALIVE);
+  }
+  if (map->dirty) {
+    UpdateTexture(game->minimap_texture, map->pixels);
+    map->dirty = false;
+  }
+
+  Rectangle rect   = gameMinimapRect(game);
+  Rectangle source = {
+    .x      = 0,
+    .y      = 0,
+    .width  = map->columns,
+    .height = map->rows,
+  };
+  DrawTexturePro(game->minimap_texture, source, rect, (Vector2){ 0 }, 0, WHITE);
+  DrawRectangleLinesEx(rect, 1, GRAY);
+
+  f32 scale = rect.width / (map->columns * map->tile);
+  Rectangle view = {
+    .x      = rect.x + game->view.x * scale,
+    .y      = rect.y + game->view.y * scale,
+    .width  = game->view.width * scale,
+    .height = game->view.height * scale,
+  };
+  DrawRectangleLinesEx(view, 2, BLUE);
+}
+
+// gameRender renders game field and updates game state if necessary
+local void gameRender(Game* game) {
+  // Cells outside of the view are clipped, e.g. the neighbors of the
+  // selected cell.
+  BeginScissorMode(game->rect.x, game->rect.y, game->rect.width, game->rect.height);
+
+  switch (game->engine) {
+    case ENGINE_LIFE:
+    case ENGINE_MARGOLUS:
+    case ENGINE_HASHLIFE:
+    case ENGINE_QUICKLIFE:
+      if (gameIsHex(game)) {
+        gameRenderField(game);
+      } else {
+        gameRenderCells(game);
+      }
+      break;
+    case ENGINE_LENIA:
+      gameRenderTexture(game, game->lenia.current, 1.0f);
+      break;
+    case ENGINE_GRAY_SCOTT:
+      gameRenderTexture(game, game->gray_scott.v, 0.5f);
+      break;
+    case ENGINE_COLOR_LIFE:
+      gameRenderColorLife(game);
+      break;
+    case ENGINE_PACKED:
+      gameRenderCells(game);
+      break;
+  }
+
   if (game->selected) {
     i32 x = game->x;
     i32 y = game->y;
@@ -452,40 +1581,254 @@ local void gameRender(Game* game) {
     Color primary   = GRAY;
     Color secondary = Fade(primary, 0.2);
 
-    gameRenderCell(game, x,     y,     primary);
-    gameRenderCell(game, x - 1, y,     secondary); // W
-    gameRenderCell(game, x - 1, y - 1, secondary); // NW
-    gameRenderCell(game, x,     y - 1, secondary); // N
-    gameRenderCell(game, x + 1, y - 1, secondary); // NE
-    gameRenderCell(game, x + 1, y,     secondary); // E
-    gameRenderCell(game, x + 1, y + 1, secondary); // SE
-    gameRenderCell(game, x,     y + 1, secondary); // S
-    gameRenderCell(game, x - 1, y + 1, secondary); // SW
-                                                   //
+    // Engines without the field keep it zeroed, so they highlight Moore
+    // neighborhood.
+    i32 offsets[MAX_NEIGHBORS][2];
+    u32 count = fieldNeighbors(&game->field, y, offsets);
+
+    gameRenderCell(game, x, y, primary);
+    for (u32 i = 0; i < count; i++) {
+      i32 nx = x + offsets[i][0];
+      i32 ny = y + offsets[i][1];
+      if (game->engine == ENGINE_LIFE
+          && !fieldCellWrap(&game->field, &nx, &ny)) {
+        continue;
+      }
+      gameRenderCell(game, nx, ny, secondary);
+    }
+  }
+
+  if (game->has_region) {
+    Rectangle first = gameCellRect(game, game->region.x, game->region.y);
+    Rectangle rect  = {
+      .x      = first.x,
+      .y      = first.y,
+      .width  = first.width * game->region.width,
+      .height = first.height * game->region.height,
+    };
+    DrawRectangleLinesEx(rect, 2, BLUE);
+  }
+
+  EndScissorMode();
+
+  if (game->zoom > 0) {
+    gameRenderMinimap(game);
+  }
+
+  if (game->selected) {
     textDrawf(10, 10, GetFontDefault(), 20, 1, BLACK,
       "X: %d Y: %d", game->x, game->y);
-    textDrawf(10, 30, GetFontDefault(), 20, 1, BLACK,
-      "INDEX: %u", fieldCellIndex(&game->field, game->x, game->y));
+    if (game->engine == ENGINE_LIFE || game->engine == ENGINE_MARGOLUS) {
+      textDrawf(10, 30, GetFontDefault(), 20, 1, BLACK,
+        "INDEX: %zu", fieldCellIndex(&game->field, game->x, game->y));
+    }
+  }
+
+  if (game->engine == ENGINE_HASHLIFE) {
+    HashLife* life = &game->hashlife;
+    HashLifeStats* stats = &life->stats;
+    u64 results = stats->hits + stats->misses;
+    textDrawf(10, GetScreenHeight() - 30, GetFontDefault(), 20, 1, BLACK,
+      "GEN: %llu MEM: %.1f/%.1f MB HITS: %.1f%% GC: %llu (%.1f MB)",
+      (unsigned long long)life->generation, stats->bytes / 1048576.0,
+      stats->peak_bytes / 1048576.0,
+      results > 0 ? 100.0 * stats->hits / results : 0.0,
+      (unsigned long long)stats->collections, stats->reclaimed_bytes / 1048576.0);
+  }
+
+  if (game->tiled) {
+    TiledField* life = &game->tiled_field;
+    textDrawf(10, GetScreenHeight() - 30, GetFontDefault(), 20, 1, BLACK,
+      "GEN: %llu TILES: %ux%u", (unsigned long long)life->generation,
+      life->tiles_x, life->tiles_y);
+    if (game->forked) {
+      textDrawf(10, GetScreenHeight() - 50, GetFontDefault(), 20, 1, BLACK,
+        "FORK DIFFERS IN %u TILES", tiledFieldDiffer(life, &game->fork));
+    }
+  }
+
+  if (game->engine == ENGINE_QUICKLIFE) {
+    QuickLife* life = &game->quicklife;
+    textDrawf(10, GetScreenHeight() - 30, GetFontDefault(), 20, 1, BLACK,
+      "GEN: %llu TILES: %u AWAKE: %u", (unsigned long long)life->generation,
+      life->live, life->waking_count);
   }
 
   DrawRectangleLinesEx(game->rect, 2, LIGHTGRAY);
 }
 
-local i32 gameOfLife(void) {
-  InitWindow(DEFAULT_WIDHT, DEFALUT_HEIGHT, "Game of life");
+local const char* engine_titles[] = {
+  [ENGINE_LIFE]       = "Game of life",
+  [ENGINE_LENIA]      = "Lenia",
+  [ENGINE_GRAY_SCOTT] = "Gray-Scott",
+  [ENGINE_MARGOLUS]   = "Margolus",
+  [ENGINE_COLOR_LIFE] = "Color life",
+  [ENGINE_PACKED]     = "Packed life",
+  [ENGINE_HASHLIFE]   = "Hashlife",
+  [ENGINE_QUICKLIFE]  = "QuickLife",
+};
+
+// Options holds command line options.
+typedef struct {
+  Engine engine;
+  // Probabilities of birth and survival for the stochastic life rules.
+  f64 birth;
+  f64 survival;
+  // Seed for the stochastic rules.
+  u64 seed;
+  // Name of the rule: B/S rule for the life, block rule for the Margolus
+  // engine.
+  const char* rule;
+  // Neighborhood of the life and its mask for NEIGHBORHOOD_CUSTOM.
+  Neighborhood neighborhood;
+  u32 mask;
+  // Topology of the life field.
+  Topology topology;
+  // Store the life field in the tiles of the TiledField.
+  bool tiled;
+  // Rules resolved from the name after all options are parsed.
+  Rule life_rule;
+  const MargolusRule* block_rule;
+  // Number of species for the multi-color life.
+  u32 species;
+  // Density of the initial random soup.
+  f64 density;
+  // Memory limit of the hashlife in megabytes and log2 of its step.
+  u32 memory;
+  u32 step;
+  // Size of the field, zero selects default size of the engine.
+  u32 width;
+  u32 height;
+  // Run benchmark of the layouts or of the forks of the tiled field.
+  bool bench;
+  bool bench_fork;
+  // Show generations of the life stacked into the voxel volume.
+  bool history;
+} Options;
+
+// gameSize computes size of the field of the engine from the options.
+local void gameSize(const Options* options, u32* width, u32* height) {
+  Engine engine = options->engine;
+
+  // Continuous engines need more cells for the patterns to emerge.
+  bool continuous = engine == ENGINE_LENIA || engine == ENGINE_GRAY_SCOTT;
+  u32 fallback = continuous ? 512 : options->tiled ? 2 * TILE_SIZE : 100;
+  *width  = options->width  > 0 ? options->width  : fallback;
+  *height = options->height > 0 ? options->height : *width;
+  if (engine != ENGINE_LIFE && engine != ENGINE_MARGOLUS && engine != ENGINE_PACKED
+      && engine != ENGINE_HASHLIFE && engine != ENGINE_QUICKLIFE) {
+    *height = *width;
+  }
+}
+
+// gameSizeError returns requirement to the size of the field that the
+// engine does not meet, or NULL when the engine runs on the field.
+local const char* gameSizeError(const Options* options, u32 width, u32 height) {
+  switch (options->engine) {
+    case ENGINE_LIFE:
+      if (options->neighborhood == NEIGHBORHOOD_HEX && (height & 1) != 0) {
+        return "height must be even for the hex neighborhood";
+      }
+      if (options->tiled
+          && ((width & (TILE_SIZE - 1)) != 0 || (height & (TILE_SIZE - 1)) != 0)) {
+        return "tiled layout needs multiples of 64";
+      }
+      break;
+    case ENGINE_LENIA:
+      if ((width & (width - 1)) != 0 || width <= 2 * (u32)LENIA_ORBIUM.radius) {
+        return "lenia needs power of two above the kernel diameter";
+      }
+      break;
+    case ENGINE_GRAY_SCOTT:
+      if (width < 4) {
+        return "gray-scott needs at least 4 cells";
+      }
+      break;
+    case ENGINE_MARGOLUS:
+      if ((width & 1) != 0 || (height & 1) != 0) {
+        return "margolus needs even width and height";
+      }
+      break;
+    default:
+      break;
+  }
+  return NULL;
+}
+
+local i32 gameOfLife(Options* options) {
+  Engine engine = options->engine;
 
-  i32 width  = GetScreenWidth();
-  i32 height = GetScreenHeight();
-  i32 min    = (width < height) ? width : height;
+  InitWindow(DEFAULT_WIDHT, DEFALUT_HEIGHT, engine_titles[engine]);
+  workersInit(0);
+
+  u32 width, height;
+  gameSize(options, &width, &height);
+
+  // Cells are square, so the field rectangle keeps aspect ratio of the
+  // field.
+  i32 screen_width  = GetScreenWidth();
+  i32 screen_height = GetScreenHeight();
+  f32 scale = min_value((f32)screen_width / width, (f32)screen_height / height);
 
   Rectangle rect = {
-    .width  = min,
-    .height = min,
-    .x      = (width - min) / 2.0f,
-    .y      = (height - min) / 2.0f,
+    .width  = width * scale,
+    .height = height * scale,
+    .x      = (screen_width - width * scale) / 2.0f,
+    .y      = (screen_height - height * scale) / 2.0f,
   };
 
-  Game game = gameCreate(rect, 100, 0.05);
+  Game game;
+  switch (engine) {
+    case ENGINE_LIFE:
+      game = gameCreate(rect, engine, width, height, 0.05);
+      fieldSetNeighborhood(&game.field,
+          options->neighborhood, options->mask, options->life_rule);
+      game.field.topology = options->topology;
+      fieldSetProbabilities(&game.field,
+          options->birth, options->survival, options->seed);
+      if (options->tiled) {
+        game.tiled = true;
+        tiledFieldInit(&game.tiled_field, width, height, options->life_rule);
+      }
+      break;
+    case ENGINE_LENIA:
+      // Lenia is integrated in small time steps, so it runs every frame.
+      game = gameCreate(rect, engine, width, width, 0);
+      break;
+    case ENGINE_GRAY_SCOTT:
+      // Every frame runs several sub-steps of the integration.
+      game = gameCreate(rect, engine, width, width, 0);
+      break;
+    case ENGINE_MARGOLUS:
+      game = gameCreate(rect, engine, width, height, 0.05);
+      game.block_rule = options->block_rule;
+      break;
+    case ENGINE_COLOR_LIFE:
+      game = gameCreate(rect, engine, width, width, 0.05);
+      gameSetSpecies(&game, width, options->species);
+      break;
+    case ENGINE_PACKED:
+      game = gameCreate(rect, engine, width, height, 0.05);
+      game.packed.rule = options->life_rule;
+      break;
+    case ENGINE_HASHLIFE:
+      game = gameCreate(rect, engine, width, height, 0.05);
+      hashlifeInit(&game.hashlife, options->life_rule, (usize)options->memory << 20);
+      hashlifeSetStep(&game.hashlife, options->step);
+      break;
+    case ENGINE_QUICKLIFE:
+      game = gameCreate(rect, engine, width, height, 0.05);
+      quickLifeInit(&game.quicklife, options->life_rule);
+      break;
+  }
+
+  gameViewAt(&game, 0, 0, 0, 0);
+
+  game.density = options->density > 0 ? options->density : 0.35;
+  game.seed    = options->seed;
+  if (options->density > 0) {
+    gameSoup(&game);
+  }
 
   SetTargetFPS(60);
   while (!WindowShouldClose()) {
@@ -500,12 +1843,497 @@ local i32 gameOfLife(void) {
   }
 
   gameClose(&game);
+  workersClose();
   return 0;
 }
 
-i32 main(void) {
-  if (true) {
-    return gameOfLife();
+// Number of the generations kept in the space-time history, multiple of
+// VOXELS_CHUNK.
+#define HISTORY_DEPTH 128
+
+// Colors of the generations of the history, generations take them in turn
+// every VOXELS_CHUNK / 4 ticks.
+local const Color history_colors[VOXELS_COLORS - 1] = {
+  { 230, 41, 55, 255 },  { 255, 109, 52, 255 }, { 255, 161, 0, 255 },
+  { 253, 220, 40, 255 }, { 180, 220, 40, 255 }, { 0, 228, 48, 255 },
+  { 0, 190, 120, 255 },  { 0, 180, 190, 255 },  { 0, 121, 241, 255 },
+  { 60, 80, 230, 255 },  { 112, 31, 126, 255 }, { 160, 60, 200, 255 },
+  { 200, 122, 255, 255 }, { 230, 90, 180, 255 }, { 190, 33, 100, 255 },
+};
+
+// HistoryScene shows generations of the life as layers of the voxels, the
+// newest generation is on the top. Layers of the chunks form a ring, the
+// oldest layer of the chunks is cleared and reused when the newest one is
+// full, so a tick remeshes only the chunks of one or two layers.
+typedef struct {
+  Field field;
+  Voxels voxels;
+  // Meshes of the chunks on the GPU and the number of the faces their
+  // buffers can hold.
+  Mesh* meshes;
+  u32* capacities;
+  Material material;
+  // Number of the generations written into the volume.
+  u64 generation;
+  // Number of the chunks remeshed by the last tick and the time it took
+  // to rebuild and upload them.
+  u32 remeshed;
+  f64 mesh_seconds;
+} HistoryScene;
+
+// historyUpload copies mesh of the chunk to the GPU, buffers are updated in
+// place while the faces fit them.
+local void historyUpload(HistoryScene* scene, u32 index) {
+  VoxelMesh* source = &scene->voxels.chunks[index].mesh;
+  Mesh* mesh = &scene->meshes[index];
+
+  if (mesh->vaoId == 0 || source->faces > scene->capacities[index]) {
+    if (mesh->vaoId != 0) {
+      UnloadMesh(*mesh);
+    }
+    if (source->faces == 0) {
+      *mesh = (Mesh){ 0 };
+      return;
+    }
+
+    // Buffers take the whole capacity of the chunk mesh to leave room for
+    // the growth, arrays stay owned by the chunk.
+    *mesh = (Mesh){
+      .vertexCount   = source->capacity * 6,
+      .triangleCount = source->capacity * 2,
+      .vertices      = source->vertices,
+      .colors        = source->colors,
+    };
+    UploadMesh(mesh, true);
+    mesh->vertices = NULL;
+    mesh->colors   = NULL;
+    scene->capacities[index] = source->capacity;
+  } else {
+    // Index of the buffers of the positions and the colors in vboId.
+    UpdateMeshBuffer(*mesh, 0, source->vertices, source->faces * 18 * sizeof(f32), 0);
+    UpdateMeshBuffer(*mesh, 3, source->colors, source->faces * 24 * sizeof(u8), 0);
+  }
+  mesh->vertexCount   = source->faces * 6;
+  mesh->triangleCount = source->faces * 2;
+}
+
+// historyRemesh rebuilds meshes of the changed chunks and uploads them.
+local void historyRemesh(HistoryScene* scene) {
+  Voxels* voxels = &scene->voxels;
+  f64 start = GetTime();
+  scene->remeshed = voxelsMesh(voxels);
+  for (u32 i = 0; i < scene->remeshed; i++) {
+    historyUpload(scene, voxels->dirty[i]);
+  }
+  scene->mesh_seconds = GetTime() - start;
+}
+
+// historyTick writes the current generation into its layer of the volume,
+// advances the field and remeshes changed chunks.
+local void historyTick(HistoryScene* scene) {
+  Field* field    = &scene->field;
+  Voxels* voxels  = &scene->voxels;
+  u32 y     = scene->generation % voxels->height;
+  u8  color = 1 + scene->generation / (VOXELS_CHUNK / 4) % (VOXELS_COLORS - 1);
+
+  for (u32 z = 0; z < field->height; z++) {
+    const u8* row = field->current + (usize)z * field->pitch;
+    for (u32 x = 0; x < field->width; x++) {
+      voxelsSet(voxels, x, y, z, row[x] == ALIVE ? color : 0);
+    }
+  }
+  // Full layer makes the next one the oldest, it is cleared before it is
+  // shown on the top.
+  if (y % VOXELS_CHUNK == VOXELS_CHUNK - 1) {
+    u32 next = (y + 1) % voxels->height;
+    for (u32 k = next; k < next + VOXELS_CHUNK; k++) {
+      for (u32 z = 0; z < voxels->depth; z++) {
+        for (u32 x = 0; x < voxels->width; x++) {
+          voxelsSet(voxels, x, k, z, 0);
+        }
+      }
+    }
+  }
+  scene->generation++;
+  fieldUpdate(field);
+  historyRemesh(scene);
+}
+
+// historyRender draws meshes of the chunks, layers of the chunks are
+// placed by their age and the whole volume is centered on the origin.
+local void historyRender(HistoryScene* scene) {
+  Voxels* voxels = &scene->voxels;
+  u32 head = (scene->generation + voxels->height - 1) % voxels->height / VOXELS_CHUNK;
+
+  for (u32 cy = 0; cy < voxels->layers; cy++) {
+    u32 age = (head + voxels->layers - cy) % voxels->layers;
+    f32 y   = (f32)(voxels->layers - 1 - age) * VOXELS_CHUNK - voxels->height * 0.5f;
+    for (u32 cz = 0; cz < voxels->rows; cz++) {
+      for (u32 cx = 0; cx < voxels->columns; cx++) {
+        Mesh mesh = scene->meshes[(cy * voxels->rows + cz) * voxels->columns + cx];
+        if (mesh.triangleCount == 0) {
+          continue;
+        }
+        f32 x = (f32)cx * VOXELS_CHUNK - voxels->width * 0.5f;
+        f32 z = (f32)cz * VOXELS_CHUNK - voxels->depth * 0.5f;
+        DrawMesh(mesh, scene->material, MatrixTranslate(x, y, z));
+      }
+    }
   }
-  return cube();
+}
+
+// history runs the life and shows its space-time history as voxels:
+//   Space pauses, R restarts from the new random soup, O turns the ambient
+//   occlusion on and off.
+local i32 history(Options* options) {
+  u32 width  = options->width  > 0 ? options->width  : 128;
+  u32 height = options->height > 0 ? options->height : width;
+  if (width % VOXELS_CHUNK != 0 || height % VOXELS_CHUNK != 0) {
+    fprintf(stderr, "History size must be multiple of %u\n", VOXELS_CHUNK);
+    return 1;
+  }
+
+  InitWindow(DEFAULT_WIDHT, DEFALUT_HEIGHT, "Space-time history");
+  workersInit(0);
+
+  f32 distance = max_value(width, height) * 1.2f;
+  Camera3D camera = {
+    .position   = { .x = distance, .y = distance * 0.8f, .z = distance },
+    .target     = { .x = 0.0f,     .y = 0.0f,            .z = 0.0f },
+    .up         = { .x = 0.0f,     .y = 1.0f,            .z = 0.0f },
+    .fovy       = 45.0f,
+    .projection = CAMERA_PERSPECTIVE,
+  };
+
+  u32 colors[VOXELS_COLORS] = { 0 };
+  for (u32 i = 1; i < VOXELS_COLORS; i++) {
+    memcpy(&colors[i], &history_colors[i - 1], sizeof(u32));
+  }
+
+  HistoryScene scene = { 0 };
+  fieldInit(&scene.field, width, height);
+  fieldSetNeighborhood(&scene.field, options->neighborhood, options->mask, options->life_rule);
+  scene.field.topology = options->topology;
+  fieldSetProbabilities(&scene.field, options->birth, options->survival, options->seed);
+  f64 density = options->density > 0 ? options->density : 0.35;
+  u64 seed    = options->seed;
+  fieldRandomize(&scene.field, density, seed);
+
+  voxelsInit(&scene.voxels, width, HISTORY_DEPTH, height, colors);
+  u32 chunks = scene.voxels.columns * scene.voxels.rows * scene.voxels.layers;
+  scene.meshes     = gcalloc(chunks, sizeof(Mesh));
+  scene.capacities = gcalloc(chunks, sizeof(u32));
+  scene.material   = LoadMaterialDefault();
+
+  bool pause = false;
+  SetTargetFPS(60);
+  while (!WindowShouldClose()) {
+    if (IsKeyPressed(KEY_SPACE)) {
+      pause = !pause;
+    }
+    if (IsKeyPressed(KEY_R)) {
+      fieldRandomize(&scene.field, density, ++seed);
+    }
+    if (IsKeyPressed(KEY_O)) {
+      voxelsSetOcclusion(&scene.voxels, !scene.voxels.occlusion);
+    }
+    if (!pause) {
+      historyTick(&scene);
+    } else {
+      historyRemesh(&scene);
+    }
+
+    UpdateCamera(&camera, CAMERA_ORBITAL);
+
+    BeginDrawing();
+    {
+      ClearBackground(WHITE);
+
+      BeginMode3D(camera);
+      historyRender(&scene);
+      EndMode3D();
+
+      textDrawf(10, 10, GetFontDefault(), 20, 1, BLACK,
+        "GENERATION: %llu REMESHED: %u/%u CHUNKS IN %.2f MS",
+        (unsigned long long)scene.generation,
+        scene.remeshed, chunks, scene.mesh_seconds * 1e3);
+    }
+    EndDrawing();
+  }
+
+  for (u32 i = 0; i < chunks; i++) {
+    if (scene.meshes[i].vaoId != 0) {
+      UnloadMesh(scene.meshes[i]);
+    }
+  }
+  UnloadMaterial(scene.material);
+  gfree(scene.capacities);
+  gfree(scene.meshes);
+  voxelsFree(&scene.voxels);
+  fieldFree(&scene.field);
+  workersClose();
+  return 0;
+}
+
+// optionValue returns value of the option at position i and advances i.
+local const char* optionValue(i32 argc, char** argv, i32* i) {
+  if (*i + 1 >= argc) {
+    fprintf(stderr, "Missing value for %s\n", argv[*i]);
+    exit(1);
+  }
+  *i += 1;
+  return argv[*i];
+}
+
+// Usage: cube [life|packed|hashlife|quicklife|lenia|gray-scott|margolus|immigration|quadlife|cube] [options]
+//        cube bench-layout [--size WxH]
+//        cube bench-fork [--size WxH]
+//        cube bench-rubik
+//        cube bench-vectors
+//        cube bench-colorlife
+//        cube history [options]
+//
+// Command bench-layout runs without the window and compares row-major and
+// tiled layouts of the life field, size must be multiple of 64. Command
+// bench-fork forks the tiled field, edits the fork and shows how many
+// tiles the fork shares with the parent while both advance. Command
+// bench-rubik runs without the window, measures moves of the Rubik's cubes
+// of different sizes and solves random 3x3x3 scrambles, binary built
+// without the embedded tables keeps the solver tables in kociemba.tables
+// of the working directory.
+// Command bench-vectors compares per-element raymath calls with the batch
+// vector math on the lattice of the cubes. Command bench-colorlife compares
+// Immigration and QuadLife with the plain life on a single bit plane, all
+// of them run on the same soup. Command history stacks last generations of
+// the life into the voxel volume, size of the field must be multiple of 16.
+//
+// Options:
+//   --birth P      probability of birth for the life rules
+//   --survival P   probability of survival for the life rules
+//   --seed N       seed of the stochastic rules and of the random soup
+//   --density P    density of the initial random soup of the life field
+//   --size WxH     size of the field, life, packed, hashlife, quicklife and
+//                  margolus fields may be rectangular, other engines use
+//                  square of the width, hashlife and quicklife show cells
+//                  around the origin; lenia needs power of two of at least
+//                  32, gray-scott at least 4, margolus even width and
+//                  height and the hex neighborhood even height
+//   --rule NAME    rule of the life in B/S notation, e.g. B3/S23, counts
+//                  above 9 are separated by commas, e.g. B3,10/S2,3,12, or
+//                  block rule of the margolus engine: critters, bbm, sand
+//   --neighborhood moore|von-neumann|hex|custom:MASK
+//                  neighborhood of the life, bit (dy + 2) * 5 + (dx + 2) of
+//                  the MASK selects cell at offset (dx, dy)
+//   --topology torus|bounded|cylinder|klein|cross-surface
+//                  topology of the life field
+//   --layout rows|tiled
+//                  layout of the life field: rows one after another or
+//                  64x64 tiles in the Morton order, tiled life runs only
+//                  deterministic rules with the Moore neighborhood on the
+//                  torus, its size is multiple of 64, 128 by default; K
+//                  forks the tiled life and L switches to the fork and back
+//   --memory MB    memory limit of the hashlife nodes, 256 by default, at
+//                  least 3
+//   --step N       hashlife advances 2^N generations per tick, at most 59,
+//                  the game pauses when the universe cannot grow further
+i32 main(i32 argc, char** argv) {
+  Options options = {
+    .engine       = ENGINE_LIFE,
+    .birth        = 1.0,
+    .survival     = 1.0,
+    .seed         = time(NULL),
+    .neighborhood = NEIGHBORHOOD_MOORE,
+    .topology     = TOPOLOGY_TORUS,
+    .memory       = 256,
+  };
+
+  for (i32 i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+
+    if (strcmp(arg, "cube") == 0) {
+      return cube();
+    } else if (strcmp(arg, "bench-rubik") == 0) {
+      workersInit(0);
+      benchRubik();
+      workersClose();
+      return 0;
+    } else if (strcmp(arg, "bench-vectors") == 0) {
+      benchVectors(BENCH_VECTORS_EDGE);
+      return 0;
+    } else if (strcmp(arg, "bench-colorlife") == 0) {
+      workersInit(0);
+      benchColorLife(BENCH_COLOR_LIFE_SIZE, BENCH_COLOR_LIFE_GENERATIONS);
+      workersClose();
+      return 0;
+    } else if (strcmp(arg, "life") == 0) {
+      options.engine = ENGINE_LIFE;
+    } else if (strcmp(arg, "lenia") == 0) {
+      options.engine = ENGINE_LENIA;
+    } else if (strcmp(arg, "gray-scott") == 0) {
+      options.engine = ENGINE_GRAY_SCOTT;
+    } else if (strcmp(arg, "margolus") == 0) {
+      options.engine = ENGINE_MARGOLUS;
+    } else if (strcmp(arg, "immigration") == 0) {
+      options.engine  = ENGINE_COLOR_LIFE;
+      options.species = 2;
+    } else if (strcmp(arg, "quadlife") == 0) {
+      options.engine  = ENGINE_COLOR_LIFE;
+      options.species = 4;
+    } else if (strcmp(arg, "packed") == 0) {
+      options.engine = ENGINE_PACKED;
+    } else if (strcmp(arg, "hashlife") == 0) {
+      options.engine = ENGINE_HASHLIFE;
+    } else if (strcmp(arg, "quicklife") == 0) {
+      options.engine = ENGINE_QUICKLIFE;
+    } else if (strcmp(arg, "bench-layout") == 0) {
+      options.bench = true;
+    } else if (strcmp(arg, "bench-fork") == 0) {
+      options.bench_fork = true;
+    } else if (strcmp(arg, "history") == 0) {
+      options.history = true;
+    } else if (strcmp(arg, "--birth") == 0) {
+      options.birth = atof(optionValue(argc, argv, &i));
+    } else if (strcmp(arg, "--survival") == 0) {
+      options.survival = atof(optionValue(argc, argv, &i));
+    } else if (strcmp(arg, "--size") == 0) {
+      const char* size = optionValue(argc, argv, &i);
+      char* end;
+      options.width  = strtoul(size, &end, 10);
+      options.height = options.width;
+      if (*end == 'x') {
+        options.height = strtoul(end + 1, &end, 10);
+      }
+      if (*end != '\0' || options.width == 0 || options.height == 0) {
+        fprintf(stderr, "Invalid size: %s\n", size);
+        return 1;
+      }
+    } else if (strcmp(arg, "--density") == 0) {
+      options.density = atof(optionValue(argc, argv, &i));
+    } else if (strcmp(arg, "--seed") == 0) {
+      options.seed = strtoull(optionValue(argc, argv, &i), NULL, 10);
+    } else if (strcmp(arg, "--memory") == 0) {
+      const char* memory = optionValue(argc, argv, &i);
+      // Limit is given in megabytes, rounded up minimum of the hashlife.
+      u32 minimum = (hashlifeMinMemory() + (1 << 20) - 1) >> 20;
+      char* end;
+      options.memory = strtoul(memory, &end, 10);
+      if (*end != '\0' || options.memory < minimum) {
+        fprintf(stderr, "Invalid memory limit: %s, must be at least %u MB\n",
+            memory, minimum);
+        return 1;
+      }
+    } else if (strcmp(arg, "--step") == 0) {
+      const char* step = optionValue(argc, argv, &i);
+      char* end;
+      unsigned long value = strtoul(step, &end, 10);
+      if (*end != '\0' || end == step || value > HASHLIFE_MAX_STEP) {
+        fprintf(stderr, "Invalid step: %s, must be from 0 to %u\n", step,
+            HASHLIFE_MAX_STEP);
+        return 1;
+      }
+      options.step = value;
+    } else if (strcmp(arg, "--rule") == 0) {
+      options.rule = optionValue(argc, argv, &i);
+    } else if (strcmp(arg, "--neighborhood") == 0) {
+      const char* name = optionValue(argc, argv, &i);
+      if (!neighborhoodParse(name, &options.neighborhood, &options.mask)) {
+        fprintf(stderr, "Unknown neighborhood: %s\n", name);
+        return 1;
+      }
+    } else if (strcmp(arg, "--topology") == 0) {
+      const char* name = optionValue(argc, argv, &i);
+      if (!topologyParse(name, &options.topology)) {
+        fprintf(stderr, "Unknown topology: %s\n", name);
+        return 1;
+      }
+    } else if (strcmp(arg, "--layout") == 0) {
+      const char* name = optionValue(argc, argv, &i);
+      if (strcmp(name, "rows") == 0) {
+        options.tiled = false;
+      } else if (strcmp(name, "tiled") == 0) {
+        options.tiled = true;
+      } else {
+        fprintf(stderr, "Unknown layout: %s\n", name);
+        return 1;
+      }
+    } else {
+      fprintf(stderr, "Unknown argument: %s\n", arg);
+      return 1;
+    }
+  }
+
+  if (options.bench || options.bench_fork) {
+    u32 width  = options.width  > 0 ? options.width  : 4096;
+    u32 height = options.height > 0 ? options.height : width;
+    if ((width & (TILE_SIZE - 1)) != 0 || (height & (TILE_SIZE - 1)) != 0) {
+      fprintf(stderr, "Benchmark size must be multiple of %u\n", TILE_SIZE);
+      return 1;
+    }
+    workersInit(0);
+    if (options.bench) {
+      benchLayout(width, height, 16);
+    } else {
+      benchFork(width, height, 64);
+    }
+    workersClose();
+    return 0;
+  }
+
+  // Meaning of the rule depends on the engine, so it is resolved last.
+  options.life_rule  = ruleDefault(options.neighborhood);
+  options.block_rule = &MARGOLUS_CRITTERS;
+  if (options.rule != NULL) {
+    if (options.engine == ENGINE_MARGOLUS) {
+      options.block_rule = margolusRuleFind(options.rule);
+      if (options.block_rule == NULL) {
+        fprintf(stderr, "Unknown block rule: %s\n", options.rule);
+        return 1;
+      }
+    } else {
+      u32 population = neighborhoodPopulation(options.neighborhood, options.mask);
+      if (!ruleParse(options.rule, population, &options.life_rule)) {
+        fprintf(stderr, "Invalid rule: %s, counts go from 0 to %u\n",
+            options.rule, population);
+        return 1;
+      }
+    }
+  }
+
+  if (options.history) {
+    return history(&options);
+  }
+
+  bool deterministic = options.birth >= 1.0 && options.survival >= 1.0;
+  if (options.engine == ENGINE_PACKED && (!deterministic
+        || options.neighborhood != NEIGHBORHOOD_MOORE
+        || options.topology != TOPOLOGY_TORUS)) {
+    fprintf(stderr, "Packed life supports only deterministic rules with "
+        "the Moore neighborhood on the torus\n");
+    return 1;
+  }
+  if (options.tiled && (options.engine != ENGINE_LIFE || !deterministic
+        || options.neighborhood != NEIGHBORHOOD_MOORE
+        || options.topology != TOPOLOGY_TORUS)) {
+    fprintf(stderr, "Tiled layout supports only the life with deterministic "
+        "rules with the Moore neighborhood on the torus\n");
+    return 1;
+  }
+  // Birth on zero neighbors fills the whole infinite plane.
+  bool infinite = options.engine == ENGINE_HASHLIFE || options.engine == ENGINE_QUICKLIFE;
+  if (infinite && (!deterministic || options.neighborhood != NEIGHBORHOOD_MOORE
+        || (options.life_rule.birth & 1) != 0)) {
+    fprintf(stderr, "%s supports only deterministic rules without B0 with "
+        "the Moore neighborhood\n", engine_titles[options.engine]);
+    return 1;
+  }
+
+  u32 width, height;
+  gameSize(&options, &width, &height);
+  const char* error = gameSizeError(&options, width, height);
+  if (error != NULL) {
+    fprintf(stderr, "Invalid size: %ux%u, %s\n", width, height, error);
+    return 1;
+  }
+
+  return gameOfLife(&options);
 }
@@ -0,0 +1,232 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "margolus.h"
+
+#include "debug.h"
+#include "simd.h"
+#include "workers.h"
+
+#define TL 1
+#define TR 2
+#define BL 4
+#define BR 8
+
+// Critters: block with exactly two live cells is unchanged, otherwise all
+// of the cells are inverted and block with three live cells is also
+// rotated by 180 degrees.
+const MargolusRule MARGOLUS_CRITTERS = {
+  .name  = "critters",
+  .table = {
+    [0]                 = TL | TR | BL | BR,
+    [TL]                = TR | BL | BR,
+    [TR]                = TL | BL | BR,
+    [BL]                = TL | TR | BR,
+    [BR]                = TL | TR | BL,
+    [TL | TR]           = TL | TR,
+    [TL | BL]           = TL | BL,
+    [TL | BR]           = TL | BR,
+    [TR | BL]           = TR | BL,
+    [TR | BR]           = TR | BR,
+    [BL | BR]           = BL | BR,
+    [TR | BL | BR]      = BR,
+    [TL | BL | BR]      = BL,
+    [TL | TR | BR]      = TR,
+    [TL | TR | BL]      = TL,
+    [TL | TR | BL | BR] = 0,
+  },
+};
+
+// Billiard ball machine: single ball moves diagonally through the block,
+// two balls on the diagonal collide and leave on the other diagonal.
+const MargolusRule MARGOLUS_BILLIARD_BALL = {
+  .name  = "bbm",
+  .table = {
+    [0]                 = 0,
+    [TL]                = BR,
+    [TR]                = BL,
+    [BL]                = TR,
+    [BR]                = TL,
+    [TL | TR]           = TL | TR,
+    [TL | BL]           = TL | BL,
+    [TL | BR]           = TR | BL,
+    [TR | BL]           = TL | BR,
+    [TR | BR]           = TR | BR,
+    [BL | BR]           = BL | BR,
+    [TR | BL | BR]      = TR | BL | BR,
+    [TL | BL | BR]      = TL | BL | BR,
+    [TL | TR | BR]      = TL | TR | BR,
+    [TL | TR | BL]      = TL | TR | BL,
+    [TL | TR | BL | BR] = TL | TR | BL | BR,
+  },
+};
+
+// Sand: grains fall down when the cell below is empty and stacked grains
+// topple to the empty side.
+const MargolusRule MARGOLUS_SAND = {
+  .name  = "sand",
+  .table = {
+    [0]                 = 0,
+    [TL]                = BL,
+    [TR]                = BR,
+    [BL]                = BL,
+    [BR]                = BR,
+    [TL | TR]           = BL | BR,
+    [TL | BL]           = BL | BR,
+    [TL | BR]           = BL | BR,
+    [TR | BL]           = BL | BR,
+    [TR | BR]           = BL | BR,
+    [BL | BR]           = BL | BR,
+    [TR | BL | BR]      = TR | BL | BR,
+    [TL | BL | BR]      = TL | BL | BR,
+    [TL | TR | BR]      = TL | BL | BR,
+    [TL | TR | BL]      = TR | BL | BR,
+    [TL | TR | BL | BR] = TL | TR | BL | BR,
+  },
+};
+
+local const MargolusRule* rules[] = {
+  &MARGOLUS_CRITTERS,
+  &MARGOLUS_BILLIARD_BALL,
+  &MARGOLUS_SAND,
+};
+
+const MargolusRule* margolusRuleFind(const char* name) {
+  for (usize i = 0; i < sizeof(rules) / sizeof(rules[0]); i++) {
+    if (strcmp(rules[i]->name, name) == 0) {
+      return rules[i];
+    }
+  }
+  return NULL;
+}
+
+typedef struct {
+  Field* field;
+  const MargolusRule* rule;
+  // Offset of the block partition, 0 or 1.
+  u32 offset;
+} MargolusJob;
+
+// margolusBlock updates single block that may wrap around the torus and
+// returns its cells that were born or died, bits follow the block index.
+local u32 margolusBlock(MargolusJob* job, u8* top, u8* bottom, u32 x) {
+  u32 left  = x;
+  u32 right = (x + 1) % job->field->width;
+
+  u8* cells[4] = { top + left, top + right, bottom + left, bottom + right };
+
+  u32 index = 0;
+  for (u32 i = 0; i < 4; i++) {
+    index |= (*cells[i] == ALIVE) << i;
+  }
+
+  u32 next = job->rule->table[index];
+  for (u32 i = 0; i < 4; i++) {
+    *cells[i] = (next >> i) & 1 ? ALIVE : fieldFade(*cells[i]);
+  }
+  return next ^ index;
+}
+
+// margolusRow updates block row made of two lines of cells. Eight blocks
+// are processed at once: every 16-bit lane of the vector holds pair of the
+// cells, left cell in the low byte on little-endian targets. New blocks
+// are looked up in the rule table by the block index held in the low
+// bytes. Lines where any cell was born or died are flagged in the changed
+// rows of the field.
+local void margolusRow(MargolusJob* job, u32 y, u8* top, u8* bottom) {
+  u32 width = job->field->width;
+  u32 x     = job->offset;
+
+  u8x16 table = u8x16Load(job->rule->table);
+
+  u8x16 alive  = (u8x16){ 0 } + ALIVE;
+  u8x16 diying = (u8x16){ 0 } + DIYING;
+
+  u16x8 top_changes = (u16x8){ 0 };
+  u16x8 bot_changes = (u16x8){ 0 };
+  for (; x + 16 <= width; x += 16) {
+    u8x16 t = u8x16Load(top + x);
+    u8x16 b = u8x16Load(bottom + x);
+
+    // 0xff in the bytes of the live cells.
+    u16x8 ta = (u16x8)(t == alive);
+    u16x8 ba = (u16x8)(b == alive);
+
+    u16x8 index = ((ta & 0x0001) >> 0) | ((ta & 0x0100) >> 7)
+                | ((ba & 0x0001) << 2) | ((ba & 0x0100) >> 5);
+
+    // High bytes of the indices are zero, they look up the empty block.
+    u16x8 next = (u16x8)u8x16Lookup(table, (u8x16)index) & 0x00ff;
+
+    // Expand bits of the new block back to the byte masks.
+    u16x8 top_mask = ((0 - ((next >> 0) & 1)) & 0x00ff)
+                   | ((0 - ((next >> 1) & 1)) & 0xff00);
+    u16x8 bot_mask = ((0 - ((next >> 2) & 1)) & 0x00ff)
+                   | ((0 - ((next >> 3) & 1)) & 0xff00);
+
+    top_changes |= ta ^ top_mask;
+    bot_changes |= ba ^ bot_mask;
+
+    u8x16 tf = t - ((u8x16)(t >= diying) & 1);
+    u8x16 bf = b - ((u8x16)(b >= diying) & 1);
+
+    u8x16Store(top + x,    (u8x16)((u16x8)tf & ~top_mask) | (alive & (u8x16)top_mask));
+    u8x16Store(bottom + x, (u8x16)((u16x8)bf & ~bot_mask) | (alive & (u8x16)bot_mask));
+  }
+
+  u32 changes = 0;
+  for (; x < width; x += 2) {
+    changes |= margolusBlock(job, top, bottom, x);
+  }
+
+  u64 lanes[4];
+  memcpy(lanes, &top_changes, sizeof(top_changes));
+  memcpy(lanes + 2, &bot_changes, sizeof(bot_changes));
+  Field* field = job->field;
+  field->changed[y] = (lanes[0] | lanes[1]) != 0 || (changes & (TL | TR)) != 0;
+  field->changed[(y + 1) % field->height] = (lanes[2] | lanes[3]) != 0 || (changes & (BL | BR)) != 0;
+}
+
+local void margolusRows(void* ctx, u32 begin, u32 end) {
+  MargolusJob* job = ctx;
+  Field* field     = job->field;
+
+  for (u32 row = begin; row < end; row++) {
+    u32 y = 2 * row + job->offset;
+    u8* top    = field->current + (usize)y * field->pitch;
+    u8* bottom = field->current + (usize)((y + 1) % field->height) * field->pitch;
+    margolusRow(job, y, top, bottom);
+  }
+}
+
+void margolusUpdate(Field* field, const MargolusRule* rule) {
+  assertf((field->width & 1) == 0 && (field->height & 1) == 0,
+      "Margolus partition requires even size, got %ux%u",
+      field->width, field->height);
+
+  MargolusJob job = {
+    .field  = field,
+    .rule   = rule,
+    .offset = field->generation & 1,
+  };
+  workersRun(field->height / 2, margolusRows, &job);
+  field->generation++;
+}
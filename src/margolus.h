@@ -0,0 +1,64 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _MARGOLUS_H
+#define _MARGOLUS_H
+
+#include "types.h"
+#include "field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cells of the 2x2 block are numbered as bits of the block index:
+//
+//   +---+---+
+//   | 0 | 1 |
+//   +---+---+
+//   | 2 | 3 |
+//   +---+---+
+//
+// Block rule maps index of the block to the new index.
+typedef struct {
+  const char* name;
+  u8 table[16];
+} MargolusRule;
+
+extern const MargolusRule MARGOLUS_CRITTERS;
+extern const MargolusRule MARGOLUS_BILLIARD_BALL;
+extern const MargolusRule MARGOLUS_SAND;
+
+// margolusRuleFind returns rule with the given name or NULL.
+const MargolusRule* margolusRuleFind(const char* name);
+
+// margolusUpdate applies block rule to the field. Partition of the field
+// into blocks is shifted by one cell on every even generation. Blocks
+// never overlap, so field is updated in place.
+// NOTE: field width and height must be even for partition to be consistent on the
+//  torus.
+void margolusUpdate(Field* field, const MargolusRule* rule);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
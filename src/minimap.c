@@ -0,0 +1,199 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "minimap.h"
+
+#include <string.h>
+
+#include "bitplane.h"
+#include "simd.h"
+#include "workers.h"
+
+typedef struct {
+  Minimap* map;
+  // Cells are either states with the alive one, or two bit planes.
+  const u8* states;
+  u32 pitch;
+  u8 alive;
+  const u64* high;
+  const u64* low;
+  u32 words;
+} MinimapJob;
+
+// minimapCount returns number of the cells in the alive state.
+local u32 minimapCount(const u8* states, u32 count, u8 alive) {
+  u8x16 match = u8x16Splat(alive);
+  u32 result  = 0;
+  u32 i = 0;
+  for (; i + 16 <= count; i += 16) {
+    // Matching lanes are 0xff, so every match adds 8 bits.
+    u64 bits[2];
+    u8x16 equal = (u8x16)(u8x16Load(states + i) == match);
+    memcpy(bits, &equal, sizeof(bits));
+    result += (__builtin_popcountll(bits[0]) + __builtin_popcountll(bits[1])) / 8;
+  }
+  for (; i < count; i++) {
+    result += states[i] == alive;
+  }
+  return result;
+}
+
+// minimapCountBits returns number of the cells from x0 to x1 set in both
+// of the planes.
+local u32 minimapCountBits(const u64* high, const u64* low, u32 x0, u32 x1) {
+  u32 result = 0;
+  for (u32 w = x0 / BITPLANE_WORD_BITS; w * BITPLANE_WORD_BITS < x1; w++) {
+    u32 base = w * BITPLANE_WORD_BITS;
+    u32 from = max_value(x0, base) - base;
+    u32 to   = min_value(x1, base + BITPLANE_WORD_BITS) - base;
+    u64 mask = (to == BITPLANE_WORD_BITS ? ~0ull : (1ull << to) - 1) & ~((1ull << from) - 1);
+    result += __builtin_popcountll(high[w] & low[w] & mask);
+  }
+  return result;
+}
+
+local void minimapRows(void* ctx, u32 begin, u32 end) {
+  MinimapJob* job = ctx;
+  Minimap* map    = job->map;
+  u32 counts[MINIMAP_SIZE];
+  bool dirty = false;
+
+  for (u32 ty = begin; ty < end; ty++) {
+    u8* stale = map->stale + (usize)ty * map->columns;
+    if (memchr(stale, 1, map->columns) == NULL) {
+      continue;
+    }
+
+    u32 y0 = ty * map->tile;
+    u32 y1 = min_value(y0 + map->tile, map->height);
+
+    memset(counts, 0, map->columns * sizeof(u32));
+    for (u32 y = y0; y < y1; y++) {
+      for (u32 tx = 0; tx < map->columns; tx++) {
+        if (!stale[tx]) {
+          continue;
+        }
+        u32 x0 = tx * map->tile;
+        u32 x1 = min_value(x0 + map->tile, map->width);
+        if (job->states != NULL) {
+          const u8* row = job->states + (usize)y * job->pitch;
+          counts[tx] += minimapCount(row + x0, x1 - x0, job->alive);
+        } else {
+          usize row = (usize)y * job->words;
+          counts[tx] += minimapCountBits(job->high + row, job->low + row, x0, x1);
+        }
+      }
+    }
+
+    u32* pixels = map->pixels + (usize)ty * map->columns;
+    for (u32 tx = 0; tx < map->columns; tx++) {
+      if (!stale[tx]) {
+        continue;
+      }
+      u32 x0   = tx * map->tile;
+      u32 area = (min_value(x0 + map->tile, map->width) - x0) * (y1 - y0);
+      // Any alive cell makes the tile darker than the empty one.
+      u32 shade = ((u64)counts[tx] * (MINIMAP_SHADES - 1) + area - 1) / area;
+      if (pixels[tx] != map->shades[shade]) {
+        pixels[tx] = map->shades[shade];
+        dirty      = true;
+      }
+    }
+    memset(stale, 0, map->columns);
+  }
+
+  if (dirty) {
+    __atomic_store_n(&map->dirty, true, __ATOMIC_RELAXED);
+  }
+}
+
+void minimapInit(Minimap* map, u32 width, u32 height, const u32* shades) {
+  u32 side  = max_value(width, height);
+  map->tile = (side + MINIMAP_SIZE - 1) / MINIMAP_SIZE;
+
+  map->width   = width;
+  map->height  = height;
+  map->columns = (width + map->tile - 1) / map->tile;
+  map->rows    = (height + map->tile - 1) / map->tile;
+  map->pixels  = gmalloc((usize)map->columns * map->rows * sizeof(u32));
+  map->stale   = gmalloc((usize)map->columns * map->rows);
+  memcpy(map->shades, shades, sizeof(map->shades));
+
+  for (usize i = 0; i < (usize)map->columns * map->rows; i++) {
+    map->pixels[i] = shades[0];
+  }
+  map->dirty = true;
+  minimapMarkAll(map);
+}
+
+void minimapFree(Minimap* map) {
+  gfree(map->pixels);
+  gfree(map->stale);
+}
+
+void minimapMark(Minimap* map, i64 x, i64 y, i64 width, i64 height) {
+  i64 x0 = max_value(x, 0);
+  i64 y0 = max_value(y, 0);
+  i64 x1 = min_value(x + width, (i64)map->width);
+  i64 y1 = min_value(y + height, (i64)map->height);
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  for (u32 ty = y0 / map->tile; ty <= (y1 - 1) / map->tile; ty++) {
+    u8* stale = map->stale + (usize)ty * map->columns;
+    for (u32 tx = x0 / map->tile; tx <= (x1 - 1) / map->tile; tx++) {
+      map->stale_count += !stale[tx];
+      stale[tx] = 1;
+    }
+  }
+}
+
+void minimapMarkAll(Minimap* map) {
+  map->stale_count = map->columns * map->rows;
+  memset(map->stale, 1, map->stale_count);
+}
+
+void minimapUpdate(Minimap* map, const u8* states, u32 pitch, u8 alive) {
+  MinimapJob job = {
+    .map    = map,
+    .states = states,
+    .pitch  = pitch,
+    .alive  = alive,
+  };
+  if (map->stale_count > 0) {
+    workersRun(map->rows, minimapRows, &job);
+    map->stale_count = 0;
+  }
+}
+
+void minimapUpdatePlanes(Minimap* map, const u64* high, const u64* low, u32 words) {
+  MinimapJob job = {
+    .map   = map,
+    .high  = high,
+    .low   = low,
+    .words = words,
+  };
+  if (map->stale_count > 0) {
+    workersRun(map->rows, minimapRows, &job);
+    map->stale_count = 0;
+  }
+}
@@ -0,0 +1,87 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _MINIMAP_H
+#define _MINIMAP_H
+
+// Coarse overview of the whole field, every pixel shows density of the
+// alive cells of the square tile.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest side of the minimap in pixels.
+#define MINIMAP_SIZE   128
+// Number of the shades of the density.
+#define MINIMAP_SHADES 16
+
+typedef struct {
+  // Size of the field in cells and side of the tile under single pixel.
+  u32 width;
+  u32 height;
+  u32 tile;
+  // Size of the image in pixels.
+  u32 columns;
+  u32 rows;
+  // Pixels of the image, colors are 32-bit pixels in the memory order of
+  // the texture.
+  u32* pixels;
+  // Colors of the densities from the empty tile to the full one.
+  u32 shades[MINIMAP_SHADES];
+  // Set when pixels changed since they were uploaded.
+  bool dirty;
+  // Flags of the tiles whose cells changed since the last update and the
+  // number of them.
+  u8* stale;
+  u32 stale_count;
+} Minimap;
+
+// minimapInit creates minimap of the field of the given size, all tiles
+// take the first shade.
+void minimapInit(Minimap* map, u32 width, u32 height, const u32* shades);
+
+// minimapFree frees memory of the minimap.
+void minimapFree(Minimap* map);
+
+// minimapMark marks tiles under the rectangle of the cells stale, parts of
+// the rectangle outside of the field are ignored.
+void minimapMark(Minimap* map, i64 x, i64 y, i64 width, i64 height);
+
+// minimapMarkAll marks every tile stale.
+void minimapMarkAll(Minimap* map);
+
+// minimapUpdate counts alive cells of the stale tiles on the worker threads
+// and repaints tiles whose shade changed, marking the pixels dirty. States
+// are in row-major order with the pitch between the rows.
+void minimapUpdate(Minimap* map, const u8* states, u32 pitch, u8 alive);
+
+// minimapUpdatePlanes is minimapUpdate for the cells in two bit planes with
+// the given number of words per row, alive cells are set in both of them.
+void minimapUpdatePlanes(Minimap* map, const u64* high, const u64* low, u32 words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
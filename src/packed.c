@@ -0,0 +1,252 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "packed.h"
+
+#include "bitplane.h"
+#include "debug.h"
+#include "random.h"
+#include "workers.h"
+
+// State of the cell for every 2-bit code.
+local const u8 packed_states[4] = { EMPTY, DEAD, DIYING, ALIVE };
+
+void packedFieldInit(PackedField* field, u32 width, u32 height, Rule rule) {
+  u32 words  = bitplaneWords(width);
+  usize size = (usize)words * height;
+
+  field->width      = width;
+  field->height     = height;
+  field->words      = words;
+  field->rule       = rule;
+  field->generation = 0;
+
+  field->high      = gcalloc(size, sizeof(u64));
+  field->low       = gcalloc(size, sizeof(u64));
+  field->next_high = gcalloc(size, sizeof(u64));
+  field->next_low  = gcalloc(size, sizeof(u64));
+  field->changed   = gcalloc(height, sizeof(u8));
+}
+
+void packedFieldFree(PackedField* field) {
+  gfree(field->high);
+  gfree(field->low);
+  gfree(field->next_high);
+  gfree(field->next_low);
+  gfree(field->changed);
+}
+
+// packedFieldCode returns 2-bit code of the state.
+local u32 packedFieldCode(State state) {
+  switch (state) {
+    case DEAD:
+      return 1;
+    case DIYING:
+      return 2;
+    case ALIVE:
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+// packedFieldDecodeCell returns state of the cell x of the row planes.
+local u8 packedFieldDecodeCell(const u64* high, const u64* low, u32 x) {
+  u32 shift = x % BITPLANE_WORD_BITS;
+  u32 code  = (((high[x / BITPLANE_WORD_BITS] >> shift) & 1) << 1)
+            | ((low[x / BITPLANE_WORD_BITS] >> shift) & 1);
+  return packed_states[code];
+}
+
+State packedFieldCellState(PackedField* field, i32 x, i32 y) {
+  x = modi32(x, field->width);
+  y = modi32(y, field->height);
+
+  usize row = (usize)y * field->words;
+  return packedFieldDecodeCell(field->high + row, field->low + row, x);
+}
+
+void packedFieldCellSet(PackedField* field, i32 x, i32 y, State state) {
+  x = modi32(x, field->width);
+  y = modi32(y, field->height);
+
+  usize word = (usize)y * field->words + x / BITPLANE_WORD_BITS;
+  u64 bit    = 1ull << (x % BITPLANE_WORD_BITS);
+  u32 code   = packedFieldCode(state);
+
+  field->high[word] = (field->high[word] & ~bit) | ((code & 2) ? bit : 0);
+  field->low[word]  = (field->low[word] & ~bit) | ((code & 1) ? bit : 0);
+}
+
+void packedFieldDecodeRow(PackedField* field, u32 y, u32 x, u32 count, u8* states) {
+  const u64* high = field->high + (usize)y * field->words;
+  const u64* low  = field->low + (usize)y * field->words;
+  u32 end = x + count;
+  u32 i   = x;
+
+  // Cells before the first whole byte of the planes go one by one.
+  for (; i < end && i % 8 != 0; i++) {
+    states[i - x] = packedFieldDecodeCell(high, low, i);
+  }
+
+  // Every byte of the planes expands into eight cells at once: state is
+  // 2 * high + low + (high | low), that maps codes 0, 1, 2, 3 to EMPTY,
+  // DEAD, DIYING and ALIVE without carries between the bytes.
+  for (; i + 8 <= end; i += 8) {
+    u8 hb = high[i / BITPLANE_WORD_BITS] >> (i % BITPLANE_WORD_BITS);
+    u8 lb = low[i / BITPLANE_WORD_BITS] >> (i % BITPLANE_WORD_BITS);
+    u64 h = bitplaneSpread(hb);
+    u64 l = bitplaneSpread(lb);
+    u64 cells = 2 * h + l + (h | l);
+    memcpy(states + i - x, &cells, sizeof(cells));
+  }
+
+  for (; i < end; i++) {
+    states[i - x] = packedFieldDecodeCell(high, low, i);
+  }
+}
+
+void packedFieldEncodeRow(PackedField* field, u32 y, const u8* states) {
+  u64* high = field->high + (usize)y * field->words;
+  u64* low  = field->low + (usize)y * field->words;
+
+  memset(high, 0, field->words * sizeof(u64));
+  memset(low, 0, field->words * sizeof(u64));
+  for (u32 x = 0; x < field->width; x++) {
+    u32 code = packedFieldCode(states[x]);
+    u64 bit  = 1ull << (x % BITPLANE_WORD_BITS);
+    if (code & 2) {
+      high[x / BITPLANE_WORD_BITS] |= bit;
+    }
+    if (code & 1) {
+      low[x / BITPLANE_WORD_BITS] |= bit;
+    }
+  }
+}
+
+typedef struct {
+  PackedField* field;
+  u32 threshold;
+  u64 seed;
+} PackedSoupJob;
+
+local void packedFieldSoupRows(void* ctx, u32 begin, u32 end) {
+  PackedSoupJob* job = ctx;
+  PackedField* field = job->field;
+  u8* states = gmalloc(field->width);
+
+  for (u32 y = begin; y < end; y++) {
+    randomFillThreshold(job->seed, RANDOM_STREAM_SOUP, (u64)y * field->width,
+        job->threshold, ALIVE, EMPTY, states, field->width);
+    packedFieldEncodeRow(field, y, states);
+  }
+
+  gfree(states);
+}
+
+void packedFieldRandomize(PackedField* field, f64 density, u64 seed) {
+  PackedSoupJob job = {
+    .field     = field,
+    .threshold = max_value(0, min_value(1, density)) * FIELD_CERTAIN,
+    .seed      = seed,
+  };
+  workersRun(field->height, packedFieldSoupRows, &job);
+}
+
+local void packedFieldRows(void* ctx, u32 begin, u32 end) {
+  PackedField* field = ctx;
+  u32 words  = field->words;
+  u32 width  = field->width;
+  u32 height = field->height;
+
+  // Plane of the live cells of the three rows around the current one.
+  u64* scratch = gmalloc((usize)words * 3 * sizeof(u64));
+  u64* rows[3] = { scratch, scratch + words, scratch + 2 * words };
+
+  for (u32 r = 0; r < 2; r++) {
+    usize offset = (usize)modi32((i32)begin - 1 + r, height) * words;
+    for (u32 i = 0; i < words; i++) {
+      rows[r][i] = field->high[offset + i] & field->low[offset + i];
+    }
+  }
+
+  for (u32 y = begin; y < end; y++) {
+    usize mid  = (usize)y * words;
+    usize down = (usize)modi32((i32)y + 1, height) * words;
+    for (u32 i = 0; i < words; i++) {
+      rows[2][i] = field->high[down + i] & field->low[down + i];
+    }
+
+    const u64* up     = rows[0];
+    const u64* center = rows[1];
+    const u64* below  = rows[2];
+
+    u64 changed = 0;
+    for (u32 i = 0; i < words; i++) {
+      u64 n[8] = {
+        bitplaneWest(up, words, width, i),
+        up[i],
+        bitplaneEast(up, words, width, i),
+        bitplaneWest(center, words, width, i),
+        bitplaneEast(center, words, width, i),
+        bitplaneWest(below, words, width, i),
+        below[i],
+        bitplaneEast(below, words, width, i),
+      };
+      u64 s[4];
+      bitplaneCount(n, s);
+
+      u64 high  = field->high[mid + i];
+      u64 low   = field->low[mid + i];
+      u64 alive = center[i];
+      u64 next  = (alive & bitplaneMatch(s, field->rule.survival))
+                | (~alive & bitplaneMatch(s, field->rule.birth));
+
+      // Cells past the end of the row stay empty.
+      if (i == words - 1 && width % BITPLANE_WORD_BITS != 0) {
+        next &= (1ull << (width % BITPLANE_WORD_BITS)) - 1;
+      }
+
+      // ALIVE fades into DIYING, DIYING and DEAD into DEAD and EMPTY stays
+      // EMPTY.
+      field->next_high[mid + i] = next | alive;
+      field->next_low[mid + i]  = next | (~alive & (high | low));
+      changed |= next ^ alive;
+    }
+    field->changed[y] = changed != 0;
+
+    u64* recycled = rows[0];
+    rows[0] = rows[1];
+    rows[1] = rows[2];
+    rows[2] = recycled;
+  }
+
+  gfree(scratch);
+}
+
+void packedFieldUpdate(PackedField* field) {
+  workersRun(field->height, packedFieldRows, field);
+
+  u64* tmp;
+  tmp = field->high; field->high = field->next_high; field->next_high = tmp;
+  tmp = field->low;  field->low  = field->next_low;  field->next_low  = tmp;
+  field->generation++;
+}
@@ -0,0 +1,94 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _PACKED_H
+#define _PACKED_H
+
+#include "types.h"
+#include "field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// PackedField is the life field on the torus with two bits per cell. Bits
+// of the state code are stored in two bit planes, 64 cells per word:
+//
+//   high low  state
+//     0   0   EMPTY
+//     0   1   DEAD
+//     1   0   DIYING
+//     1   1   ALIVE
+//
+// so the whole transition, including fading of the dead cells, is computed
+// with word-parallel logic. It uses the Moore neighborhood and gives the
+// same states as the Field with the deterministic rule.
+typedef struct {
+  // Size of the field in cells.
+  u32 width;
+  u32 height;
+  // Number of words in a single row of the plane
+  u32 words;
+  // Rule of the automaton.
+  Rule rule;
+
+  // Planes with high and low bits of the state codes.
+  u64* high;
+  u64* low;
+  // Planes for the next generation.
+  u64* next_high;
+  u64* next_low;
+  // Flags of the rows where any cell was born or died in the last update.
+  u8* changed;
+
+  // Number of generations since the start.
+  u64 generation;
+} PackedField;
+
+void packedFieldInit(PackedField* field, u32 width, u32 height, Rule rule);
+void packedFieldFree(PackedField* field);
+
+// packedFieldCellState returns state of the cell, coordinates are wrapped.
+State packedFieldCellState(PackedField* field, i32 x, i32 y);
+
+// packedFieldCellSet sets cell state, coordinates are wrapped.
+void packedFieldCellSet(PackedField* field, i32 x, i32 y, State state);
+
+// packedFieldDecodeRow writes states of count cells of the row y starting
+// from the column x.
+void packedFieldDecodeRow(PackedField* field, u32 y, u32 x, u32 count, u8* states);
+
+// packedFieldEncodeRow replaces cells of the row y with given states.
+void packedFieldEncodeRow(PackedField* field, u32 y, const u8* states);
+
+// packedFieldRandomize fills field with live cells with given density, the
+// rest of the cells are empty. Cells get the same values as from the
+// fieldRandomize with the same seed.
+void packedFieldRandomize(PackedField* field, f64 density, u64 seed);
+
+// packedFieldUpdate advances field by single generation.
+void packedFieldUpdate(PackedField* field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "pixels.h"
+
+#include <string.h>
+
+#include "simd.h"
+#include "workers.h"
+
+// Flag of the pixel columns on the vertical grid lines.
+#define PIXELS_GRID_COLUMN (1u << 31)
+
+typedef struct {
+  const PixelsView* view;
+  // Cell column under every pixel column, with the grid flag.
+  u32* columns;
+  bool grid;
+  // Bytes of the palette colors, one table per byte of the pixel.
+  u8x16 channels[4];
+} PixelsJob;
+
+// pixelsCellRow returns row of the cells under the pixel row.
+local inline u32 pixelsCellRow(const PixelsView* view, u32 y) {
+  return (u64)y * view->height / view->pixels_height;
+}
+
+// pixelsLookup writes pixels of 16 cells, palette bytes are looked up with
+// shuffles and interleaved into the pixels.
+local inline void pixelsLookup(const PixelsJob* job, const u8* states, u32* out) {
+  u8x16 indices = u8x16Load(states);
+  u8x16 c0 = u8x16Lookup(job->channels[0], indices);
+  u8x16 c1 = u8x16Lookup(job->channels[1], indices);
+  u8x16 c2 = u8x16Lookup(job->channels[2], indices);
+  u8x16 c3 = u8x16Lookup(job->channels[3], indices);
+
+  u16x8 c01_low  = (u16x8)u8x16InterleaveLow(c0, c1);
+  u16x8 c01_high = (u16x8)u8x16InterleaveHigh(c0, c1);
+  u16x8 c23_low  = (u16x8)u8x16InterleaveLow(c2, c3);
+  u16x8 c23_high = (u16x8)u8x16InterleaveHigh(c2, c3);
+
+  u16x8 pixels[4] = {
+    u16x8InterleaveLow(c01_low, c23_low),
+    u16x8InterleaveHigh(c01_low, c23_low),
+    u16x8InterleaveLow(c01_high, c23_high),
+    u16x8InterleaveHigh(c01_high, c23_high),
+  };
+  memcpy(out, pixels, sizeof(pixels));
+}
+
+// pixelsRow converts cells of the row into the pixel row.
+local void pixelsRow(const PixelsJob* job, u32 cy, u32* out) {
+  const PixelsView* view = job->view;
+  const u8* states = view->states + (usize)cy * view->pitch;
+  const u8* ages   = view->ages != NULL ? view->ages + (usize)cy * view->width : NULL;
+  u32 x = 0;
+
+  // Cells map to the pixels one to one.
+  if (view->pixels_width == view->width && ages == NULL) {
+    if (SIMD_BYTE_SHUFFLE) {
+      for (; x + 16 <= view->pixels_width; x += 16) {
+        pixelsLookup(job, states + x, out + x);
+      }
+    }
+    for (; x < view->pixels_width; x++) {
+      out[x] = view->palette[states[x] & (PIXELS_PALETTE - 1)];
+    }
+  }
+
+  for (; x < view->pixels_width; x++) {
+    u32 column = job->columns[x];
+    if (column & PIXELS_GRID_COLUMN) {
+      out[x] = view->grid;
+    } else if (ages != NULL && ages[column] != 0) {
+      out[x] = view->heat[ages[column]];
+    } else {
+      out[x] = view->palette[states[column] & (PIXELS_PALETTE - 1)];
+    }
+  }
+}
+
+local void pixelsRows(void* ctx, u32 begin, u32 end) {
+  const PixelsJob* job   = ctx;
+  const PixelsView* view = job->view;
+  u32 width = view->pixels_width;
+
+  // Pixel rows over the same cell row are the same, the first one is
+  // copied.
+  const u32* cached = NULL;
+  u32 cached_row    = UINT32_MAX;
+
+  for (u32 y = begin; y < end; y++) {
+    u32* out = view->pixels + (usize)y * width;
+    u32 cy   = pixelsCellRow(view, y);
+
+    if (job->grid && (y == 0 || pixelsCellRow(view, y - 1) != cy)) {
+      for (u32 x = 0; x < width; x++) {
+        out[x] = view->grid;
+      }
+    } else if (cy == cached_row) {
+      memcpy(out, cached, width * sizeof(u32));
+    } else {
+      pixelsRow(job, cy, out);
+      cached     = out;
+      cached_row = cy;
+    }
+  }
+}
+
+void pixelsRender(const PixelsView* view) {
+  PixelsJob job = {
+    .view    = view,
+    .columns = gmalloc(view->pixels_width * sizeof(u32)),
+    .grid    = view->pixels_width >= view->width * PIXELS_GRID
+      && view->pixels_height >= view->height * PIXELS_GRID,
+  };
+
+  for (u32 x = 0; x < view->pixels_width; x++) {
+    u32 column = (u64)x * view->width / view->pixels_width;
+    bool line  = job.grid
+      && (x == 0 || (job.columns[x - 1] & ~PIXELS_GRID_COLUMN) != column);
+    job.columns[x] = line ? column | PIXELS_GRID_COLUMN : column;
+  }
+
+  for (u32 i = 0; i < PIXELS_PALETTE; i++) {
+    u8 bytes[4];
+    memcpy(bytes, &view->palette[i], sizeof(bytes));
+    for (u32 k = 0; k < 4; k++) {
+      job.channels[k][i] = bytes[k];
+    }
+  }
+
+  workersRun(view->pixels_height, pixelsRows, &job);
+  gfree(job.columns);
+}
+
+typedef struct {
+  u8* ages;
+  const u8* states;
+  u32 pitch;
+  u32 width;
+  u8 alive;
+} PixelsAgeJob;
+
+local void pixelsAgeRows(void* ctx, u32 begin, u32 end) {
+  PixelsAgeJob* job = ctx;
+  u8x16 alive = u8x16Splat(job->alive);
+
+  for (u32 y = begin; y < end; y++) {
+    u8* ages         = job->ages + (usize)y * job->width;
+    const u8* states = job->states + (usize)y * job->pitch;
+
+    u32 x = 0;
+    for (; x + 16 <= job->width; x += 16) {
+      u8x16 age  = u8x16Load(ages + x);
+      u8x16 cell = u8x16Load(states + x);
+      // Lanes of the comparisons are -1, so subtraction increments the ages
+      // below the limit.
+      age -= (u8x16)(age != u8x16Splat(255));
+      age &= (u8x16)(cell == alive);
+      u8x16Store(ages + x, age);
+    }
+    for (; x < job->width; x++) {
+      ages[x] = states[x] == job->alive ? ages[x] + (ages[x] < 255) : 0;
+    }
+  }
+}
+
+void pixelsAge(u8* ages, const u8* states, u32 pitch, u32 width, u32 height, u8 alive) {
+  PixelsAgeJob job = {
+    .ages   = ages,
+    .states = states,
+    .pitch  = pitch,
+    .width  = width,
+    .alive  = alive,
+  };
+  workersRun(height, pixelsAgeRows, &job);
+}
@@ -0,0 +1,76 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _PIXELS_H
+#define _PIXELS_H
+
+// Conversion of the cell states into the pixels of the texture.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of the colors in the palette of the states, states are below it.
+#define PIXELS_PALETTE 16
+// Number of the colors of the ages.
+#define PIXELS_HEAT    256
+// Grid lines are drawn when cells are at least this many pixels wide.
+#define PIXELS_GRID    8
+
+// PixelsView describes the cells and the pixels they are stretched over.
+// Colors are 32-bit pixels in the memory order of the texture.
+typedef struct {
+  // Cells in row-major order with the pitch between the rows.
+  const u8* states;
+  u32 pitch;
+  u32 width;
+  u32 height;
+  // Ages of the cells packed row after row, or NULL. Cells with non-zero
+  // age take the color of the age.
+  const u8* ages;
+
+  const u32* palette;
+  const u32* heat;
+  u32 grid;
+
+  // Pixels of the texture.
+  u32* pixels;
+  u32 pixels_width;
+  u32 pixels_height;
+} PixelsView;
+
+// pixelsRender converts cells into pixels on the worker threads, every
+// pixel takes the color of the cell under its top left corner.
+void pixelsRender(const PixelsView* view);
+
+// pixelsAge advances ages of the cells, cells in the alive state grow
+// older up to 255 and the rest of them are reset to zero. States are in
+// row-major order with the pitch between the rows, ages are packed row
+// after row.
+void pixelsAge(u8* ages, const u8* states, u32 pitch, u32 width, u32 height, u8 alive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
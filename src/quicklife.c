@@ -0,0 +1,494 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "quicklife.h"
+
+#include <string.h>
+
+#include "bitplane.h"
+#include "debug.h"
+#include "workers.h"
+
+// Sleeping empty tiles are released every QUICKLIFE_SWEEP generations.
+#define QUICKLIFE_SWEEP 64
+
+// Offsets of the neighbor tiles by the direction.
+local const i32 quick_life_dx[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+local const i32 quick_life_dy[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+// Rows of the missing neighbor.
+local const u64 quick_life_empty[QUICKLIFE_TILE];
+
+// quickLifeKey packs tile position into the key of the map.
+local inline u64 quickLifeKey(i32 x, i32 y) {
+  return ((u64)(u32)x << 32) | (u32)y;
+}
+
+// quickLifeSlot returns home slot of the key.
+local inline u32 quickLifeSlot(QuickLife* life, u64 key) {
+  return ((key * 0x9E3779B97F4A7C15ull) >> 32) & life->map_mask;
+}
+
+// quickLifeFind returns index of the tile at the position or
+// QUICKLIFE_NONE.
+local u32 quickLifeFind(QuickLife* life, i32 x, i32 y) {
+  u64 key = quickLifeKey(x, y);
+  for (u32 slot = quickLifeSlot(life, key);; slot = (slot + 1) & life->map_mask) {
+    if (life->values[slot] == QUICKLIFE_NONE || life->keys[slot] == key) {
+      return life->values[slot];
+    }
+  }
+}
+
+// quickLifeMapPut inserts tile into the map, the key must be absent.
+local void quickLifeMapPut(QuickLife* life, u64 key, u32 index) {
+  u32 slot = quickLifeSlot(life, key);
+  while (life->values[slot] != QUICKLIFE_NONE) {
+    slot = (slot + 1) & life->map_mask;
+  }
+  life->keys[slot]   = key;
+  life->values[slot] = index;
+  life->map_count++;
+}
+
+// quickLifeMapResize rebuilds map with given number of slots.
+local void quickLifeMapResize(QuickLife* life, u32 slots) {
+  u64* keys   = life->keys;
+  u32* values = life->values;
+  u32 count   = life->map_mask + 1;
+
+  life->keys      = gmalloc(slots * sizeof(u64));
+  life->values    = gmalloc(slots * sizeof(u32));
+  life->map_mask  = slots - 1;
+  life->map_count = 0;
+  memset(life->values, 0xFF, slots * sizeof(u32));
+
+  if (keys != NULL) {
+    for (u32 slot = 0; slot < count; slot++) {
+      if (values[slot] != QUICKLIFE_NONE) {
+        quickLifeMapPut(life, keys[slot], values[slot]);
+      }
+    }
+    gfree(keys);
+    gfree(values);
+  }
+}
+
+// quickLifeMapRemove removes key from the map, following entries of the
+// probe sequence are shifted back into the hole.
+local void quickLifeMapRemove(QuickLife* life, u64 key) {
+  u32 hole = quickLifeSlot(life, key);
+  while (life->keys[hole] != key || life->values[hole] == QUICKLIFE_NONE) {
+    hole = (hole + 1) & life->map_mask;
+  }
+  life->values[hole] = QUICKLIFE_NONE;
+  life->map_count--;
+
+  for (u32 slot = (hole + 1) & life->map_mask;
+      life->values[slot] != QUICKLIFE_NONE; slot = (slot + 1) & life->map_mask) {
+    // Entry stays when its home is cyclically in (hole, slot].
+    u32 home = quickLifeSlot(life, life->keys[slot]);
+    bool stays = hole < slot
+      ? home > hole && home <= slot
+      : home > hole || home <= slot;
+    if (!stays) {
+      life->keys[hole]   = life->keys[slot];
+      life->values[hole] = life->values[slot];
+      life->values[slot] = QUICKLIFE_NONE;
+      hole = slot;
+    }
+  }
+}
+
+// quickLifeWake schedules tile for the next generation.
+local void quickLifeWake(QuickLife* life, u32 index) {
+  QuickTile* tile = &life->tiles[index];
+  if (!tile->awake) {
+    tile->awake = true;
+    life->waking[life->waking_count++] = index;
+  }
+}
+
+// quickLifeCreate returns new empty tile at the position, it is linked to
+// its neighbors. Pool may move.
+local u32 quickLifeCreate(QuickLife* life, i32 x, i32 y) {
+  u32 index = life->free;
+  if (index != QUICKLIFE_NONE) {
+    life->free = life->tiles[index].next_free;
+  } else {
+    if (life->tile_count == life->tile_capacity) {
+      life->tile_capacity *= 2;
+      life->tiles  = grealloc(life->tiles, life->tile_capacity * sizeof(QuickTile));
+      life->active = grealloc(life->active, life->tile_capacity * sizeof(u32));
+      life->waking = grealloc(life->waking, life->tile_capacity * sizeof(u32));
+      life->dirty  = grealloc(life->dirty, life->tile_capacity * sizeof(u32));
+    }
+    index = life->tile_count++;
+  }
+
+  QuickTile* tile = &life->tiles[index];
+  memset(tile, 0, sizeof(QuickTile));
+  tile->x = x;
+  tile->y = y;
+  for (u32 d = 0; d < 8; d++) {
+    u32 neighbor = quickLifeFind(life, x + quick_life_dx[d], y + quick_life_dy[d]);
+    tile->neighbors[d] = neighbor;
+    if (neighbor != QUICKLIFE_NONE) {
+      life->tiles[neighbor].neighbors[(d + 4) & 7] = index;
+    }
+  }
+
+  if ((life->map_count + 1) * 2 > life->map_mask + 1) {
+    quickLifeMapResize(life, (life->map_mask + 1) * 2);
+  }
+  quickLifeMapPut(life, quickLifeKey(x, y), index);
+  life->live++;
+  return index;
+}
+
+// quickLifeRelease returns tile to the pool.
+local void quickLifeRelease(QuickLife* life, u32 index) {
+  QuickTile* tile = &life->tiles[index];
+  for (u32 d = 0; d < 8; d++) {
+    if (tile->neighbors[d] != QUICKLIFE_NONE) {
+      life->tiles[tile->neighbors[d]].neighbors[(d + 4) & 7] = QUICKLIFE_NONE;
+    }
+  }
+
+  quickLifeMapRemove(life, quickLifeKey(tile->x, tile->y));
+  tile->next_free = life->free;
+  life->free = index;
+  life->live--;
+}
+
+// quickLifeTileAt returns tile at the position, it is created when it is
+// missing.
+local u32 quickLifeTileAt(QuickLife* life, i32 x, i32 y) {
+  u32 index = quickLifeFind(life, x, y);
+  return index != QUICKLIFE_NONE ? index : quickLifeCreate(life, x, y);
+}
+
+void quickLifeInit(QuickLife* life, Rule rule) {
+  assertf((rule.birth & 1) == 0, "Infinite plane does not support rules with B0");
+
+  u32 capacity = 64;
+  *life = (QuickLife){
+    .rule          = rule,
+    .tiles         = gmalloc(capacity * sizeof(QuickTile)),
+    .tile_capacity = capacity,
+    .free          = QUICKLIFE_NONE,
+    .active        = gmalloc(capacity * sizeof(u32)),
+    .waking        = gmalloc(capacity * sizeof(u32)),
+    .dirty         = gmalloc(capacity * sizeof(u32)),
+  };
+  quickLifeMapResize(life, capacity * 2);
+}
+
+void quickLifeFree(QuickLife* life) {
+  gfree(life->tiles);
+  gfree(life->keys);
+  gfree(life->values);
+  gfree(life->active);
+  gfree(life->waking);
+  gfree(life->dirty);
+  life->tiles  = NULL;
+  life->keys   = NULL;
+  life->values = NULL;
+  life->active = NULL;
+  life->waking = NULL;
+  life->dirty  = NULL;
+}
+
+// quickLifeCompute writes the next generation of the tile and notes which
+// of its borders changed and which are alive.
+local void quickLifeCompute(QuickLife* life, QuickTile* tile) {
+  u32 parity = life->generation & 1;
+  const u64* rows[8];
+  for (u32 d = 0; d < 8; d++) {
+    u32 neighbor = tile->neighbors[d];
+    rows[d] = neighbor != QUICKLIFE_NONE ? life->tiles[neighbor].rows[parity] : quick_life_empty;
+  }
+  const u64* center = tile->rows[parity];
+
+  // Rows of the tile with the rows of the northern and southern neighbors,
+  // and the same rows shifted to hold western and eastern neighbors.
+  u64 mid[QUICKLIFE_TILE + 2];
+  u64 west[QUICKLIFE_TILE + 2];
+  u64 east[QUICKLIFE_TILE + 2];
+  u64 last = QUICKLIFE_TILE - 1;
+
+  mid[0]  = rows[QUICKLIFE_NORTH][last];
+  west[0] = (mid[0] << 1) | (rows[QUICKLIFE_NORTH_WEST][last] >> 63);
+  east[0] = (mid[0] >> 1) | (rows[QUICKLIFE_NORTH_EAST][last] << 63);
+  for (u32 y = 0; y < QUICKLIFE_TILE; y++) {
+    mid[y + 1]  = center[y];
+    west[y + 1] = (center[y] << 1) | (rows[QUICKLIFE_WEST][y] >> 63);
+    east[y + 1] = (center[y] >> 1) | (rows[QUICKLIFE_EAST][y] << 63);
+  }
+  mid[last + 2]  = rows[QUICKLIFE_SOUTH][0];
+  west[last + 2] = (mid[last + 2] << 1) | (rows[QUICKLIFE_SOUTH_WEST][0] >> 63);
+  east[last + 2] = (mid[last + 2] >> 1) | (rows[QUICKLIFE_SOUTH_EAST][0] << 63);
+
+  u64* next = tile->rows[parity ^ 1];
+  u64 diff_any  = 0;
+  u64 diff_west = 0;
+  u64 diff_east = 0;
+  u64 alive_west = 0;
+  u64 alive_east = 0;
+
+  for (u32 y = 0; y < QUICKLIFE_TILE; y++) {
+    u64 n[8] = {
+      west[y], mid[y], east[y],
+      west[y + 1], east[y + 1],
+      west[y + 2], mid[y + 2], east[y + 2],
+    };
+    u64 s[4];
+    bitplaneCount(n, s);
+
+    u64 alive = mid[y + 1];
+    u64 cells = (alive & bitplaneMatch(s, life->rule.survival))
+              | (~alive & bitplaneMatch(s, life->rule.birth));
+    u64 diff = cells ^ alive;
+
+    next[y]     = cells;
+    diff_any   |= diff;
+    diff_west  |= diff & 1;
+    diff_east  |= diff >> 63;
+    alive_west |= cells & 1;
+    alive_east |= cells >> 63;
+  }
+
+  u64 diff_north = next[0] ^ center[0];
+  u64 diff_south = next[last] ^ center[last];
+
+  tile->dirty   = diff_any != 0;
+  tile->changed = (diff_north != 0) << QUICKLIFE_NORTH
+    | ((diff_north >> 63) & 1) << QUICKLIFE_NORTH_EAST
+    | diff_east << QUICKLIFE_EAST
+    | ((diff_south >> 63) & 1) << QUICKLIFE_SOUTH_EAST
+    | (diff_south != 0) << QUICKLIFE_SOUTH
+    | (diff_south & 1) << QUICKLIFE_SOUTH_WEST
+    | diff_west << QUICKLIFE_WEST
+    | (diff_north & 1) << QUICKLIFE_NORTH_WEST;
+  tile->border = (next[0] != 0) << QUICKLIFE_NORTH
+    | ((next[0] >> 63) & 1) << QUICKLIFE_NORTH_EAST
+    | alive_east << QUICKLIFE_EAST
+    | ((next[last] >> 63) & 1) << QUICKLIFE_SOUTH_EAST
+    | (next[last] != 0) << QUICKLIFE_SOUTH
+    | (next[last] & 1) << QUICKLIFE_SOUTH_WEST
+    | alive_west << QUICKLIFE_WEST
+    | (next[0] & 1) << QUICKLIFE_NORTH_WEST;
+}
+
+local void quickLifeTiles(void* ctx, u32 begin, u32 end) {
+  QuickLife* life = ctx;
+  for (u32 i = begin; i < end; i++) {
+    quickLifeCompute(life, &life->tiles[life->active[i]]);
+  }
+}
+
+// quickLifeIsEmpty reports whether the tile has no alive cells.
+local bool quickLifeIsEmpty(QuickLife* life, QuickTile* tile) {
+  const u64* rows = tile->rows[life->generation & 1];
+  u64 any = 0;
+  for (u32 y = 0; y < QUICKLIFE_TILE; y++) {
+    any |= rows[y];
+  }
+  return any == 0;
+}
+
+// quickLifeSweep releases sleeping empty tiles, they are created again
+// when their neighbors grow alive cells on the border.
+local void quickLifeSweep(QuickLife* life) {
+  u32 count = 0;
+  for (u32 slot = 0; slot <= life->map_mask; slot++) {
+    u32 index = life->values[slot];
+    if (index != QUICKLIFE_NONE && !life->tiles[index].awake
+        && quickLifeIsEmpty(life, &life->tiles[index])) {
+      life->active[count++] = index;
+    }
+  }
+  for (u32 i = 0; i < count; i++) {
+    quickLifeRelease(life, life->active[i]);
+  }
+}
+
+void quickLifeStep(QuickLife* life) {
+  // Tiles woken since the last step are computed now.
+  u32* active = life->waking;
+  life->waking       = life->active;
+  life->active       = active;
+  life->active_count = life->waking_count;
+  life->waking_count = 0;
+  for (u32 i = 0; i < life->active_count; i++) {
+    life->tiles[life->active[i]].awake = false;
+  }
+
+  workersRun(life->active_count, quickLifeTiles, life);
+
+  // Changed tiles stay awake and wake neighbors across the changed
+  // borders, alive borders need the neighbors to exist. Awake tiles are
+  // never swept, so the list of the changed ones stays valid.
+  life->dirty_count = 0;
+  for (u32 i = 0; i < life->active_count; i++) {
+    u32 index = life->active[i];
+    if (life->tiles[index].dirty) {
+      quickLifeWake(life, index);
+      life->dirty[life->dirty_count++] = index;
+    }
+
+    for (u32 d = 0; d < 8; d++) {
+      QuickTile* tile = &life->tiles[index];
+      u32 neighbor = tile->neighbors[d];
+      if (neighbor == QUICKLIFE_NONE && (tile->border >> d) & 1) {
+        neighbor = quickLifeCreate(life,
+            tile->x + quick_life_dx[d], tile->y + quick_life_dy[d]);
+        quickLifeWake(life, neighbor);
+      } else if (neighbor != QUICKLIFE_NONE && (tile->changed >> d) & 1) {
+        quickLifeWake(life, neighbor);
+      }
+    }
+  }
+
+  life->generation++;
+  if (life->generation % QUICKLIFE_SWEEP == 0) {
+    quickLifeSweep(life);
+  }
+}
+
+State quickLifeCellState(QuickLife* life, i64 x, i64 y) {
+  u32 index = quickLifeFind(life, x >> 6, y >> 6);
+  if (index == QUICKLIFE_NONE) {
+    return EMPTY;
+  }
+  u64 row = life->tiles[index].rows[life->generation & 1][y & (QUICKLIFE_TILE - 1)];
+  return (row >> (x & (QUICKLIFE_TILE - 1))) & 1 ? ALIVE : EMPTY;
+}
+
+// quickLifeTouch wakes tile with edited cells and its neighbors, the other
+// buffer of the tile is stale until it is computed. Missing neighbors are
+// created for the births next to the tile.
+local void quickLifeTouch(QuickLife* life, u32 index) {
+  quickLifeWake(life, index);
+  for (u32 d = 0; d < 8; d++) {
+    QuickTile* tile = &life->tiles[index];
+    u32 neighbor = tile->neighbors[d];
+    if (neighbor == QUICKLIFE_NONE) {
+      neighbor = quickLifeCreate(life,
+          tile->x + quick_life_dx[d], tile->y + quick_life_dy[d]);
+    }
+    quickLifeWake(life, neighbor);
+  }
+}
+
+void quickLifeCellSet(QuickLife* life, i64 x, i64 y, bool alive) {
+  assertf(x >> 6 >= INT32_MIN && x >> 6 <= INT32_MAX && y >> 6 >= INT32_MIN && y >> 6 <= INT32_MAX,
+      "Cell %lld %lld is out of the plane", (long long)x, (long long)y);
+
+  u32 index = quickLifeTileAt(life, x >> 6, y >> 6);
+  u64* row  = &life->tiles[index].rows[life->generation & 1][y & (QUICKLIFE_TILE - 1)];
+  u64 bit   = 1ull << (x & (QUICKLIFE_TILE - 1));
+  *row = alive ? *row | bit : *row & ~bit;
+  quickLifeTouch(life, index);
+}
+
+u64 quickLifePopulation(QuickLife* life) {
+  u64 population = 0;
+  for (u32 slot = 0; slot <= life->map_mask; slot++) {
+    u32 index = life->values[slot];
+    if (index == QUICKLIFE_NONE) {
+      continue;
+    }
+    const u64* rows = life->tiles[index].rows[life->generation & 1];
+    for (u32 y = 0; y < QUICKLIFE_TILE; y++) {
+      population += __builtin_popcountll(rows[y]);
+    }
+  }
+  return population;
+}
+
+void quickLifeFromField(QuickLife* life, Field* field) {
+  Rule rule = life->rule;
+  quickLifeFree(life);
+  quickLifeInit(life, rule);
+
+  u32 parity = life->generation & 1;
+  i64 left   = -(i64)(field->width / 2);
+  i64 top    = -(i64)(field->height / 2);
+
+  for (u32 y = 0; y < field->height; y++) {
+    const u8* cells = &field->current[(usize)y * field->pitch];
+    u32 index = QUICKLIFE_NONE;
+    for (u32 x = 0; x < field->width; x++) {
+      if (cells[x] != ALIVE) {
+        continue;
+      }
+      i64 px = left + x;
+      i64 py = top + y;
+      if (index == QUICKLIFE_NONE || life->tiles[index].x != px >> 6) {
+        index = quickLifeTileAt(life, px >> 6, py >> 6);
+      }
+      life->tiles[index].rows[parity][py & (QUICKLIFE_TILE - 1)] |= 1ull << (px & (QUICKLIFE_TILE - 1));
+    }
+  }
+
+  // Map changes while the tiles are touched, so they are listed first.
+  u32 count = 0;
+  for (u32 slot = 0; slot <= life->map_mask; slot++) {
+    if (life->values[slot] != QUICKLIFE_NONE) {
+      life->active[count++] = life->values[slot];
+    }
+  }
+  u32* tiles = gmalloc(max_value(count, 1) * sizeof(u32));
+  memcpy(tiles, life->active, count * sizeof(u32));
+  for (u32 i = 0; i < count; i++) {
+    quickLifeTouch(life, tiles[i]);
+  }
+  gfree(tiles);
+}
+
+void quickLifeToField(QuickLife* life, Field* field, i64 x, i64 y) {
+  memset(field->current, EMPTY, (usize)field->pitch * field->height);
+
+  u32 parity = life->generation & 1;
+  for (i64 ty = y >> 6; ty <= (y + field->height - 1) >> 6; ty++) {
+    for (i64 tx = x >> 6; tx <= (x + field->width - 1) >> 6; tx++) {
+      u32 index = quickLifeFind(life, tx, ty);
+      if (index == QUICKLIFE_NONE) {
+        continue;
+      }
+
+      const u64* rows = life->tiles[index].rows[parity];
+      for (u32 row = 0; row < QUICKLIFE_TILE; row++) {
+        i64 fy = ty * QUICKLIFE_TILE + row - y;
+        if (fy < 0 || fy >= field->height) {
+          continue;
+        }
+        for (u64 bits = rows[row]; bits != 0; bits &= bits - 1) {
+          i64 fx = tx * QUICKLIFE_TILE + __builtin_ctzll(bits) - x;
+          if (fx >= 0 && fx < field->width) {
+            field->current[(usize)fy * field->pitch + fx] = ALIVE;
+          }
+        }
+      }
+    }
+  }
+}
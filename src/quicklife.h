@@ -0,0 +1,134 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _QUICKLIFE_H
+#define _QUICKLIFE_H
+
+#include "types.h"
+#include "field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Side of the tile, row of the tile is single word.
+#define QUICKLIFE_TILE 64
+// Index that refers to no tile.
+#define QUICKLIFE_NONE UINT32_MAX
+
+// Directions to the neighbor tiles, opposite direction is (d + 4) % 8.
+typedef enum {
+  QUICKLIFE_NORTH      = 0,
+  QUICKLIFE_NORTH_EAST = 1,
+  QUICKLIFE_EAST       = 2,
+  QUICKLIFE_SOUTH_EAST = 3,
+  QUICKLIFE_SOUTH      = 4,
+  QUICKLIFE_SOUTH_WEST = 5,
+  QUICKLIFE_WEST       = 6,
+  QUICKLIFE_NORTH_WEST = 7,
+} QuickLifeDirection;
+
+// QuickTile is the 64x64 block of cells, bit x of the row word is the cell
+// at column x.
+typedef struct {
+  // Position of the tile in tiles.
+  i32 x;
+  i32 y;
+  // Rows of the current and the next generation, selected by the parity of
+  // the generation. Rows of the sleeping tile are the same in both.
+  u64 rows[2][QUICKLIFE_TILE];
+  // Neighbor tiles by the direction, or QUICKLIFE_NONE.
+  u32 neighbors[8];
+  // Directions whose border cells changed and directions whose border
+  // cells are alive after the last computation of the tile.
+  u8 changed;
+  u8 border;
+  // Any cell of the tile changed in the last computation.
+  bool dirty;
+  // Tile is computed in the next generation.
+  bool awake;
+  // Next tile in the free list.
+  u32 next_free;
+} QuickTile;
+
+// QuickLife is the infinite life plane with the Moore neighborhood and the
+// deterministic rule without B0, stored as sparse map of the bitboard
+// tiles. Only tiles that changed in the previous generation or border
+// tiles of the changed ones are computed, the rest of them sleep.
+typedef struct {
+  // Rule of the automaton.
+  Rule rule;
+
+  // Pool of the tiles with the list of released ones.
+  QuickTile* tiles;
+  u32 tile_count;
+  u32 tile_capacity;
+  u32 free;
+  // Number of live tiles.
+  u32 live;
+
+  // Open addressing map from the tile position to its index.
+  u64* keys;
+  u32* values;
+  u32 map_mask;
+  u32 map_count;
+
+  // Tiles computed in the current and in the next generation.
+  u32* active;
+  u32 active_count;
+  u32* waking;
+  u32 waking_count;
+  // Tiles whose cells changed in the last generation.
+  u32* dirty;
+  u32 dirty_count;
+
+  // Number of generations since the start.
+  u64 generation;
+} QuickLife;
+
+void quickLifeInit(QuickLife* life, Rule rule);
+void quickLifeFree(QuickLife* life);
+
+// quickLifeStep advances the plane by single generation.
+void quickLifeStep(QuickLife* life);
+
+// quickLifeCellState returns ALIVE or EMPTY state of the cell.
+State quickLifeCellState(QuickLife* life, i64 x, i64 y);
+
+// quickLifeCellSet makes cell alive or dead.
+void quickLifeCellSet(QuickLife* life, i64 x, i64 y, bool alive);
+
+// quickLifePopulation returns number of alive cells.
+u64 quickLifePopulation(QuickLife* life);
+
+// quickLifeFromField replaces plane with alive cells of the field, the
+// field is centered at the origin.
+void quickLifeFromField(QuickLife* life, Field* field);
+
+// quickLifeToField writes cells of the plane with top left corner at
+// (x, y) into the field, cells are ALIVE or EMPTY.
+void quickLifeToField(QuickLife* life, Field* field, i64 x, i64 y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,95 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "random.h"
+
+// Single Philox block produces 128 bits, that is eight 16-bit values.
+#define VALUES_PER_BLOCK 8
+// Blocks are generated four at a time.
+#define VALUES_PER_BATCH (VALUES_PER_BLOCK * 4)
+// Number of values drawn at once by randomFillThreshold.
+#define THRESHOLD_CHUNK 512
+
+void randomFill16(u64 seed, u64 generation, u64 first, u16* out, u32 count) {
+  u32 key0 = (u32)seed;
+  u32 key1 = (u32)(seed >> 32);
+
+  u64 begin = first - (first % VALUES_PER_BATCH);
+  u64 end   = first + count;
+
+  for (u64 batch = begin; batch < end; batch += VALUES_PER_BATCH) {
+    u64 block = batch / VALUES_PER_BLOCK;
+    u32x4 ctr[4] = {
+      { (u32)block, (u32)(block + 1), (u32)(block + 2), (u32)(block + 3) },
+      u32x4Splat((u32)(block >> 32)),
+      u32x4Splat((u32)generation),
+      u32x4Splat((u32)(generation >> 32)),
+    };
+    philox4x32(ctr, key0, key1);
+
+    // Transpose lanes, so values of the block are consecutive.
+    u32 words[16];
+    for (u32 lane = 0; lane < 4; lane++) {
+      for (u32 w = 0; w < 4; w++) {
+        words[lane * 4 + w] = ctr[w][lane];
+      }
+    }
+
+    u16 values[VALUES_PER_BATCH];
+    memcpy(values, words, sizeof(values));
+
+    u64 from = max_value(batch, first);
+    u64 to   = min_value(batch + VALUES_PER_BATCH, end);
+    for (u64 i = from; i < to; i++) {
+      out[i - first] = values[i - batch];
+    }
+  }
+}
+
+void randomFillThreshold(u64 seed, u64 generation, u64 first, u32 threshold,
+    u8 hit, u8 miss, u8* out, u32 count) {
+  if (threshold > UINT16_MAX) {
+    memset(out, hit, count);
+    return;
+  }
+
+  u16x8 limit  = u16x8Splat(threshold);
+  u16x8 hits   = u16x8Splat(hit);
+  u16x8 misses = u16x8Splat(miss);
+  u16 values[THRESHOLD_CHUNK];
+
+  for (u32 offset = 0; offset < count; offset += THRESHOLD_CHUNK) {
+    u32 length = min_value(count - offset, THRESHOLD_CHUNK);
+    randomFill16(seed, generation, first + offset, values, length);
+
+    u8* dst = out + offset;
+    u32 i = 0;
+    for (; i + 8 <= length; i += 8) {
+      u16x8 mask  = (u16x8)(u16x8Load(values + i) < limit);
+      u16x8 cells = (mask & hits) | (~mask & misses);
+      u8x8 bytes  = __builtin_convertvector(cells, u8x8);
+      memcpy(dst + i, &bytes, sizeof(bytes));
+    }
+    for (; i < length; i++) {
+      dst[i] = values[i] < threshold ? hit : miss;
+    }
+  }
+}
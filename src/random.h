@@ -0,0 +1,90 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _RANDOM_H
+#define _RANDOM_H
+
+// Counter-based random numbers: every value is a pure function of the key
+// and the counter, so results do not depend on the order of evaluation or
+// on the number of threads.
+
+#include "types.h"
+#include "simd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef u64 u64x4 __attribute__((vector_size(32)));
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+// philox4x32 computes four Philox4x32-10 blocks at once. Lane i of ctr[j]
+// holds word j of the i-th counter, results are written back in the same
+// layout.
+local inline void philox4x32(u32x4 ctr[4], u32 key0, u32 key1) {
+  u32x4 c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+
+  for (u32 round = 0; round < 10; round++) {
+    u64x4 p0 = __builtin_convertvector(c0, u64x4) * PHILOX_M0;
+    u64x4 p1 = __builtin_convertvector(c2, u64x4) * PHILOX_M1;
+
+    u32x4 hi0 = __builtin_convertvector(p0 >> 32, u32x4);
+    u32x4 lo0 = __builtin_convertvector(p0, u32x4);
+    u32x4 hi1 = __builtin_convertvector(p1 >> 32, u32x4);
+    u32x4 lo1 = __builtin_convertvector(p1, u32x4);
+
+    c0 = hi1 ^ c1 ^ key0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ key1;
+    c3 = lo0;
+
+    key0 += PHILOX_W0;
+    key1 += PHILOX_W1;
+  }
+
+  ctr[0] = c0; ctr[1] = c1; ctr[2] = c2; ctr[3] = c3;
+}
+
+// Stream of the random values used to fill the fields with random cells,
+// it never collides with the generations of the stochastic rules.
+#define RANDOM_STREAM_SOUP UINT64_MAX
+
+// randomFill16 writes uniformly distributed 16-bit values for the elements
+// [first, first + count) of the stream identified by seed and generation.
+// Value of the element depends only on its index, so any part of the
+// stream can be generated independently.
+void randomFill16(u64 seed, u64 generation, u64 first, u16* out, u32 count);
+
+// randomFillThreshold draws 16-bit values the same way as randomFill16 and
+// writes hit for the values below the threshold and miss for the rest.
+// Threshold of 0x10000 or more always hits.
+void randomFillThreshold(u64 seed, u64 generation, u64 first, u32 threshold,
+    u8 hit, u8 miss, u8* out, u32 count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
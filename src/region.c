@@ -0,0 +1,309 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "region.h"
+
+#include "debug.h"
+#include "random.h"
+#include "simd.h"
+#include "workers.h"
+
+// Side of the square blocks used by the pattern rotation.
+#define REGION_BLOCK 32
+
+// RegionSpan is a continuous part of the region row inside of the field.
+typedef struct {
+  // Column of the field.
+  u32 column;
+  // Offset from the start of the region row.
+  u32 offset;
+  u32 length;
+} RegionSpan;
+
+typedef enum {
+  REGION_FILL,
+  REGION_CLEAR,
+  REGION_COPY,
+  REGION_PASTE,
+} RegionOp;
+
+typedef struct {
+  Field* field;
+  RegionOp op;
+  Region region;
+  // Spans of the every row, region crossing glued edge is split in two.
+  RegionSpan spans[2];
+  u32 span_count;
+  bool wrap_y;
+  // Pattern copied to or pasted from.
+  Pattern* pattern;
+  PasteMode mode;
+  // Parameters of the fill.
+  u32 threshold;
+  u64 seed;
+} RegionJob;
+
+// regionWrapX reports whether region crossing left or right edge wraps.
+local bool regionWrapX(Field* field) {
+  return field->topology == TOPOLOGY_TORUS
+    || field->topology == TOPOLOGY_CYLINDER
+    || field->topology == TOPOLOGY_KLEIN_BOTTLE;
+}
+
+// regionWrapY reports whether region crossing top or bottom edge wraps.
+local bool regionWrapY(Field* field) {
+  return field->topology == TOPOLOGY_TORUS;
+}
+
+// regionSpans splits range [start, start + length) into the spans inside
+// of [0, size) and returns number of the spans.
+local u32 regionSpans(i32 start, u32 length, u32 size, bool wrap,
+    RegionSpan spans[2]) {
+  if (wrap) {
+    length = min_value(length, size);
+    u32 column = ((start % (i32)size) + size) % size;
+    u32 first  = min_value(length, size - column);
+
+    spans[0] = (RegionSpan){ .column = column, .offset = 0, .length = first };
+    if (first == length) {
+      return 1;
+    }
+    spans[1] = (RegionSpan){ .column = 0, .offset = first, .length = length - first };
+    return 2;
+  }
+
+  i64 begin = max_value((i64)start, 0);
+  i64 end   = min_value((i64)start + length, (i64)size);
+  if (begin >= end) {
+    return 0;
+  }
+  spans[0] = (RegionSpan){
+    .column = begin,
+    .offset = begin - start,
+    .length = end - begin,
+  };
+  return 1;
+}
+
+// regionPasteCells combines row of the pattern with the row of the field.
+local void regionPasteCells(u8* dst, const u8* src, u32 length, PasteMode mode) {
+  if (mode == PASTE_OVERWRITE) {
+    memcpy(dst, src, length);
+    return;
+  }
+
+  u8x16 alive = u8x16Splat(ALIVE);
+  u8x16 dead  = u8x16Splat(DEAD);
+
+  u32 i = 0;
+  for (; i + 16 <= length; i += 16) {
+    u8x16 s = u8x16Load(src + i);
+    u8x16 d = u8x16Load(dst + i);
+    u8x16 mask = (u8x16)(s == alive);
+    u8x16 next = alive;
+    if (mode == PASTE_XOR) {
+      u8x16 toggled = (u8x16)(d == alive);
+      next = (toggled & dead) | (~toggled & alive);
+    }
+    u8x16Store(dst + i, (mask & next) | (~mask & d));
+  }
+
+  for (; i < length; i++) {
+    if (src[i] != ALIVE) {
+      continue;
+    }
+    if (mode == PASTE_XOR && dst[i] == ALIVE) {
+      dst[i] = DEAD;
+    } else {
+      dst[i] = ALIVE;
+    }
+  }
+}
+
+// regionRows applies operation to the rows of the region in range
+// [begin, end).
+local void regionRows(void* ctx, u32 begin, u32 end) {
+  RegionJob* job = ctx;
+  Field* field   = job->field;
+  u32 height     = field->height;
+
+  for (u32 row = begin; row < end; row++) {
+    i64 y = (i64)job->region.y + row;
+    if (job->wrap_y) {
+      y = ((y % height) + height) % height;
+    } else if (y < 0 || y >= height) {
+      continue;
+    }
+
+    u8* cells = field->current + (usize)y * field->pitch;
+    u8* pattern_row = NULL;
+    if (job->pattern != NULL) {
+      pattern_row = job->pattern->cells + (usize)row * job->pattern->width;
+    }
+
+    for (u32 i = 0; i < job->span_count; i++) {
+      RegionSpan span = job->spans[i];
+      u8* dst = cells + span.column;
+
+      switch (job->op) {
+        case REGION_FILL:
+          randomFillThreshold(job->seed, RANDOM_STREAM_SOUP,
+              (u64)y * field->width + span.column, job->threshold, ALIVE, EMPTY,
+              dst, span.length);
+          break;
+        case REGION_CLEAR:
+          memset(dst, EMPTY, span.length);
+          break;
+        case REGION_COPY:
+          memcpy(pattern_row + span.offset, dst, span.length);
+          break;
+        case REGION_PASTE:
+          regionPasteCells(dst, pattern_row + span.offset, span.length, job->mode);
+          break;
+      }
+    }
+  }
+}
+
+// regionRun applies operation to every row of the region.
+local void regionRun(RegionJob* job) {
+  Field* field = job->field;
+  job->wrap_y  = regionWrapY(field);
+  job->span_count = regionSpans(job->region.x, job->region.width,
+      field->width, regionWrapX(field), job->spans);
+
+  // Wrapped region never covers the same row twice.
+  u32 rows = job->region.height;
+  if (job->wrap_y) {
+    rows = min_value(rows, field->height);
+  }
+  workersRun(rows, regionRows, job);
+}
+
+void regionFill(Field* field, Region region, f64 density, u64 seed) {
+  RegionJob job = {
+    .field     = field,
+    .op        = REGION_FILL,
+    .region    = region,
+    .threshold = max_value(0, min_value(1, density)) * FIELD_CERTAIN,
+    .seed      = seed,
+  };
+  regionRun(&job);
+}
+
+void regionClear(Field* field, Region region) {
+  RegionJob job = {
+    .field  = field,
+    .op     = REGION_CLEAR,
+    .region = region,
+  };
+  regionRun(&job);
+}
+
+void regionCopy(Field* field, Region region, Pattern* pattern) {
+  pattern->width  = region.width;
+  pattern->height = region.height;
+  pattern->cells  = gcalloc((usize)region.width * region.height, sizeof(u8));
+
+  RegionJob job = {
+    .field   = field,
+    .op      = REGION_COPY,
+    .region  = region,
+    .pattern = pattern,
+  };
+  regionRun(&job);
+}
+
+void regionPaste(Field* field, const Pattern* pattern, i32 x, i32 y, PasteMode mode) {
+  RegionJob job = {
+    .field   = field,
+    .op      = REGION_PASTE,
+    .region  = { .x = x, .y = y, .width = pattern->width, .height = pattern->height },
+    .pattern = (Pattern*)pattern,
+    .mode    = mode,
+  };
+  regionRun(&job);
+}
+
+void patternRotate(Pattern* pattern) {
+  u32 width  = pattern->width;
+  u32 height = pattern->height;
+  u8* cells  = gmalloc((usize)width * height);
+
+  // Cell (x, y) moves to (height - 1 - y, x), blocks keep both source and
+  // destination rows in cache.
+  for (u32 by = 0; by < height; by += REGION_BLOCK) {
+    for (u32 bx = 0; bx < width; bx += REGION_BLOCK) {
+      u32 ey = min_value(by + REGION_BLOCK, height);
+      u32 ex = min_value(bx + REGION_BLOCK, width);
+      for (u32 y = by; y < ey; y++) {
+        const u8* src = pattern->cells + (usize)y * width;
+        for (u32 x = bx; x < ex; x++) {
+          cells[(usize)x * height + (height - 1 - y)] = src[x];
+        }
+      }
+    }
+  }
+
+  gfree(pattern->cells);
+  pattern->cells  = cells;
+  pattern->width  = height;
+  pattern->height = width;
+}
+
+void patternFlip(Pattern* pattern, bool horizontal) {
+  u32 width  = pattern->width;
+  u32 height = pattern->height;
+  if (width == 0 || height == 0) {
+    return;
+  }
+
+  if (horizontal) {
+    for (u32 y = 0; y < height; y++) {
+      u8* row = pattern->cells + (usize)y * width;
+      for (u32 l = 0, r = width - 1; l < r; l++, r--) {
+        u8 cell = row[l];
+        row[l]  = row[r];
+        row[r]  = cell;
+      }
+    }
+    return;
+  }
+
+  u8* temp = gmalloc(width);
+  for (u32 t = 0, b = height - 1; t < b; t++, b--) {
+    u8* top    = pattern->cells + (usize)t * width;
+    u8* bottom = pattern->cells + (usize)b * width;
+    memcpy(temp, top, width);
+    memcpy(top, bottom, width);
+    memcpy(bottom, temp, width);
+  }
+  gfree(temp);
+}
+
+void patternFree(Pattern* pattern) {
+  if (pattern->cells != NULL) {
+    gfree(pattern->cells);
+  }
+  pattern->cells  = NULL;
+  pattern->width  = 0;
+  pattern->height = 0;
+}
@@ -0,0 +1,92 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _REGION_H
+#define _REGION_H
+
+// Bulk operations on the rectangular regions of the field. Regions may
+// cross the edges of the field: they wrap along the edges that are glued
+// without a twist and are clipped by the rest of them.
+
+#include "types.h"
+#include "field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Region is a rectangle of cells, its origin may be outside of the field.
+typedef struct {
+  i32 x;
+  i32 y;
+  u32 width;
+  u32 height;
+} Region;
+
+// Pattern is a rectangle of cells detached from the field, e.g. clipboard.
+typedef struct {
+  u32 width;
+  u32 height;
+  u8* cells;
+} Pattern;
+
+// PasteMode selects how pattern is combined with the cells of the field.
+typedef enum {
+  // Cells of the field are replaced by the cells of the pattern.
+  PASTE_OVERWRITE = 0,
+  // Live cells of the pattern are added to the field.
+  PASTE_OR        = 1,
+  // Live cells of the pattern toggle cells of the field.
+  PASTE_XOR       = 2,
+} PasteMode;
+
+// regionFill fills region with live cells with given density, the rest
+// of the cells are empty. Cells get the same values as from fieldRandomize
+// with the same seed.
+void regionFill(Field* field, Region region, f64 density, u64 seed);
+
+// regionClear makes all cells of the region empty.
+void regionClear(Field* field, Region region);
+
+// regionCopy copies cells of the region into the pattern, pattern must be
+// freed with patternFree. Cells that are clipped by the bounded edges are
+// empty.
+void regionCopy(Field* field, Region region, Pattern* pattern);
+
+// regionPaste combines cells of the pattern with the field, top left cell
+// of the pattern is placed at (x, y).
+void regionPaste(Field* field, const Pattern* pattern, i32 x, i32 y, PasteMode mode);
+
+// patternRotate rotates pattern by 90 degrees clockwise.
+void patternRotate(Pattern* pattern);
+
+// patternFlip mirrors pattern horizontally, or vertically when horizontal
+// is false.
+void patternFlip(Pattern* pattern, bool horizontal);
+
+// patternFree frees resources allocated by the pattern.
+void patternFree(Pattern* pattern);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,200 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "rubik.h"
+
+#include <string.h>
+
+#include "debug.h"
+#include "random.h"
+
+// rubikFacelet returns index of the facelet with the given cubie and normal.
+local u32 rubikFacelet(u32 size, const i32 position[3], const i32 normal[3]) {
+  u32 axis = normal[0] != 0 ? 0 : normal[1] != 0 ? 1 : 2;
+  u32 face = 2 * axis + (normal[axis] < 0);
+  // Columns go along the next axis and rows along the one after it.
+  u32 column = (position[(axis + 1) % 3] + size - 1) / 2;
+  u32 row    = (position[(axis + 2) % 3] + size - 1) / 2;
+  return (face * size + row) * size + column;
+}
+
+void rubikFaceletPlace(u32 size, u32 facelet, i32 position[3], i32 normal[3]) {
+  u32 face   = facelet / (size * size);
+  u32 row    = facelet / size % size;
+  u32 column = facelet % size;
+  u32 axis   = face / 2;
+  i32 sign   = (face & 1) ? -1 : 1;
+
+  normal[0] = normal[1] = normal[2] = 0;
+  normal[axis] = sign;
+
+  position[axis]           = sign * (i32)(size - 1);
+  position[(axis + 1) % 3] = rubikCoordinate(size, column);
+  position[(axis + 2) % 3] = rubikCoordinate(size, row);
+}
+
+// rubikRotate turns the vector by quarter turn counterclockwise around the
+// axis.
+local void rubikRotate(i32 vector[3], u32 axis) {
+  i32 b = vector[(axis + 1) % 3];
+  i32 c = vector[(axis + 2) % 3];
+  vector[(axis + 1) % 3] = -c;
+  vector[(axis + 2) % 3] = b;
+}
+
+// rubikLayer writes facelets of the layer: strips of the four side faces
+// and the whole face for the outer layers. Returns number of the facelets.
+local u32 rubikLayer(u32 size, u32 axis, u32 layer, u32* facelets) {
+  i32 coordinate = rubikCoordinate(size, layer);
+  u32 count = 0;
+
+  for (u32 face = 0; face < 6; face++) {
+    u32 face_axis = face / 2;
+    i32 sign      = (face & 1) ? -1 : 1;
+    u32 base      = face * size * size;
+
+    if (face_axis == axis) {
+      if (sign * (i32)(size - 1) == coordinate) {
+        for (u32 i = 0; i < size * size; i++) {
+          facelets[count++] = base + i;
+        }
+      }
+    } else if ((face_axis + 1) % 3 == axis) {
+      // Layer crosses columns of the face.
+      for (u32 row = 0; row < size; row++) {
+        facelets[count++] = base + row * size + layer;
+      }
+    } else {
+      for (u32 column = 0; column < size; column++) {
+        facelets[count++] = base + layer * size + column;
+      }
+    }
+  }
+  return count;
+}
+
+void rubikInit(RubikCube* cube, u32 size) {
+  assertf(size >= 1 && size <= RUBIK_MAX_SIZE, "Unsupported cube size %u", size);
+
+  u32 faces  = 6 * size * size;
+  u32 moves  = 3 * size * 3;
+  // Every layer moves four strips, outer layers move their faces too.
+  usize total = (usize)moves * 4 * size + (usize)6 * 3 * size * size;
+
+  cube->size     = size;
+  cube->facelets = gmalloc(faces);
+  cube->offsets  = gmalloc((moves + 1) * sizeof(u32));
+  cube->sources  = gmalloc(total * sizeof(u32));
+  cube->targets  = gmalloc(total * sizeof(u32));
+  cube->scratch  = gmalloc(4 * size + size * size);
+
+  u32* layer = gmalloc((4 * size + size * size) * sizeof(u32));
+  u32 offset = 0;
+  for (u32 axis = 0; axis < 3; axis++) {
+    for (u32 l = 0; l < size; l++) {
+      u32 count = rubikLayer(size, axis, l, layer);
+
+      for (u32 turns = 1; turns <= 3; turns++) {
+        RubikMove move = { .axis = axis, .turns = turns, .layer = l };
+        cube->offsets[rubikMoveIndex(size, move)] = offset;
+
+        for (u32 i = 0; i < count; i++) {
+          i32 position[3], normal[3];
+          rubikFaceletPlace(size, layer[i], position, normal);
+          for (u32 t = 0; t < turns; t++) {
+            rubikRotate(position, axis);
+            rubikRotate(normal, axis);
+          }
+          cube->sources[offset] = layer[i];
+          cube->targets[offset] = rubikFacelet(size, position, normal);
+          offset++;
+        }
+      }
+    }
+  }
+  cube->offsets[moves] = offset;
+  assertf(offset == total, "Expected %zu moved facelets, got %u", total, offset);
+  gfree(layer);
+
+  rubikReset(cube);
+}
+
+void rubikFree(RubikCube* cube) {
+  gfree(cube->facelets);
+  gfree(cube->offsets);
+  gfree(cube->sources);
+  gfree(cube->targets);
+  gfree(cube->scratch);
+}
+
+void rubikReset(RubikCube* cube) {
+  u32 area = cube->size * cube->size;
+  for (u32 face = 0; face < 6; face++) {
+    memset(cube->facelets + face * area, face, area);
+  }
+}
+
+void rubikMove(RubikCube* cube, RubikMove move) {
+  assertf(move.axis < 3 && move.layer < cube->size && move.turns >= 1 && move.turns <= 3,
+      "Invalid move: axis %u, layer %u, turns %u", move.axis, move.layer, move.turns);
+
+  u32 index    = rubikMoveIndex(cube->size, move);
+  u32 begin    = cube->offsets[index];
+  u32 count    = cube->offsets[index + 1] - begin;
+  const u32* sources = cube->sources + begin;
+  const u32* targets = cube->targets + begin;
+  u8* facelets = cube->facelets;
+  u8* scratch  = cube->scratch;
+
+  for (u32 i = 0; i < count; i++) {
+    scratch[i] = facelets[sources[i]];
+  }
+  for (u32 i = 0; i < count; i++) {
+    facelets[targets[i]] = scratch[i];
+  }
+}
+
+void rubikRandomMoves(u32 size, u64 seed, RubikMove* moves, u32 count) {
+  u16* values = gmalloc(count * 3 * sizeof(u16));
+  randomFill16(seed, 0, 0, values, count * 3);
+
+  for (u32 i = 0; i < count; i++) {
+    moves[i] = (RubikMove){
+      .axis  = values[3 * i] % 3,
+      .turns = 1 + values[3 * i + 1] % 3,
+      .layer = values[3 * i + 2] % size,
+    };
+  }
+  gfree(values);
+}
+
+bool rubikSolved(const RubikCube* cube) {
+  u32 area = cube->size * cube->size;
+  for (u32 face = 0; face < 6; face++) {
+    const u8* facelets = cube->facelets + face * area;
+    for (u32 i = 1; i < area; i++) {
+      if (facelets[i] != facelets[0]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,117 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _RUBIK_H
+#define _RUBIK_H
+
+// NxNxN Rubik's cube stored as the array of the facelet colors. Every layer
+// move has precomputed table of the facelets it moves, so the move is a
+// gather of the colors followed by a scatter.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest supported number of the cubies along the edge.
+#define RUBIK_MAX_SIZE 256
+
+// Faces of the cube, face 2 * axis is on the positive side of the axis and
+// face 2 * axis + 1 on the negative one. Axes are x (right), y (up) and z
+// (front), solved face has the color of its index.
+typedef enum {
+  RUBIK_RIGHT = 0,
+  RUBIK_LEFT  = 1,
+  RUBIK_UP    = 2,
+  RUBIK_DOWN  = 3,
+  RUBIK_FRONT = 4,
+  RUBIK_BACK  = 5,
+} RubikFace;
+
+// RubikMove turns single layer perpendicular to the axis counterclockwise,
+// looking from the positive side of the axis, by the number of the quarter
+// turns. Layer 0 is on the negative side.
+typedef struct {
+  u8 axis;
+  u8 turns;
+  u16 layer;
+} RubikMove;
+
+typedef struct {
+  // Number of the cubies along the edge.
+  u32 size;
+  // Colors of the facelets, facelet (row, column) of the face is at index
+  // (face * size + row) * size + column.
+  u8* facelets;
+
+  // Facelets moved by the move are in the range [offsets[i], offsets[i + 1])
+  // of the sources and targets, move i is rubikMoveIndex of the move.
+  u32* offsets;
+  u32* sources;
+  u32* targets;
+  // Colors gathered by the move.
+  u8* scratch;
+} RubikCube;
+
+// rubikCoordinate returns coordinate of the cubie i along the axis, cubie
+// coordinates are doubled and centered, so they are integers in the range
+// [-(size - 1), size - 1].
+local inline i32 rubikCoordinate(u32 size, u32 i) {
+  return 2 * (i32)i - (i32)(size - 1);
+}
+
+// rubikMoveIndex returns index of the move in the tables.
+local inline u32 rubikMoveIndex(u32 size, RubikMove move) {
+  return (move.axis * size + move.layer) * 3 + move.turns - 1;
+}
+
+// rubikInverse returns move that undoes the move.
+local inline RubikMove rubikInverse(RubikMove move) {
+  move.turns = 4 - move.turns;
+  return move;
+}
+
+// rubikInit creates solved cube and the tables of all of its moves.
+void rubikInit(RubikCube* cube, u32 size);
+void rubikFree(RubikCube* cube);
+
+// rubikReset returns cube into the solved state.
+void rubikReset(RubikCube* cube);
+
+// rubikMove applies the move, turns are in the range [1, 3].
+void rubikMove(RubikCube* cube, RubikMove move);
+
+// rubikRandomMoves fills moves with the random moves drawn from the seed.
+void rubikRandomMoves(u32 size, u64 seed, RubikMove* moves, u32 count);
+
+// rubikSolved reports whether every face has a single color.
+bool rubikSolved(const RubikCube* cube);
+
+// rubikFaceletPlace returns doubled centered coordinates of the cubie of
+// the facelet and the outward normal of its face.
+void rubikFaceletPlace(u32 size, u32 facelet, i32 position[3], i32 normal[3]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
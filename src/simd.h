@@ -0,0 +1,191 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _SIMD_H
+#define _SIMD_H
+
+// Portable 128-bit vectors built on top of the GCC/Clang vector extensions,
+// so the same code compiles down to SSE on x86 and NEON on ARM.
+
+#include <string.h>
+
+#include "types.h"
+
+#if defined(__SSSE3__)
+# include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+# include <arm_neon.h>
+#endif
+
+#ifndef __has_builtin
+# define __has_builtin(x) 0
+#endif
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+typedef u32 u32x4 __attribute__((vector_size(16)));
+typedef u64 u64x2 __attribute__((vector_size(16)));
+typedef u16 u16x8 __attribute__((vector_size(16)));
+typedef i16 i16x8 __attribute__((vector_size(16)));
+typedef u8  u8x16 __attribute__((vector_size(16)));
+typedef u8  u8x8  __attribute__((vector_size(8)));
+
+#define F32X4_LANES 4
+
+#define f32x4Splat(v) ((f32x4){ (v), (v), (v), (v) })
+#define i32x4Splat(v) ((i32x4){ (v), (v), (v), (v) })
+#define u32x4Splat(v) ((u32x4){ (v), (v), (v), (v) })
+#define u16x8Splat(v) ((u16x8){ (v), (v), (v), (v), (v), (v), (v), (v) })
+#define u8x16Splat(v) ((u8x16){ (v), (v), (v), (v), (v), (v), (v), (v), \
+                                (v), (v), (v), (v), (v), (v), (v), (v) })
+
+// Unaligned loads and stores, memcpy is folded into a single instruction.
+local inline f32x4 f32x4Load(const f32* ptr) {
+  f32x4 result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+local inline void f32x4Store(f32* ptr, f32x4 value) {
+  memcpy(ptr, &value, sizeof(value));
+}
+
+local inline u16x8 u16x8Load(const u16* ptr) {
+  u16x8 result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+local inline u64x2 u64x2Load(const u64* ptr) {
+  u64x2 result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+local inline void u64x2Store(u64* ptr, u64x2 value) {
+  memcpy(ptr, &value, sizeof(value));
+}
+
+local inline u8x16 u8x16Load(const u8* ptr) {
+  u8x16 result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+local inline void u8x16Store(u8* ptr, u8x16 value) {
+  memcpy(ptr, &value, sizeof(value));
+}
+
+// SIMD_BYTE_SHUFFLE is set when the target shuffles bytes by the vector of
+// indices in single instruction, otherwise lookups are emulated. Baseline
+// x86-64 has no such instruction, so it is off unless SSSE3 is enabled,
+// e.g. with the CUBE_SSSE3 option of the build.
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+# define SIMD_BYTE_SHUFFLE 1
+#else
+# define SIMD_BYTE_SHUFFLE 0
+#endif
+
+// u8x16Lookup returns bytes of the table at the indices, indices are taken
+// modulo 16.
+local inline u8x16 u8x16Lookup(u8x16 table, u8x16 indices) {
+  indices &= u8x16Splat(15);
+#if defined(__SSSE3__)
+  return (u8x16)_mm_shuffle_epi8((__m128i)table, (__m128i)indices);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  return (u8x16)vqtbl1q_u8((uint8x16_t)table, (uint8x16_t)indices);
+#else
+  u8x16 result;
+  for (u32 i = 0; i < 16; i++) {
+    result[i] = table[indices[i]];
+  }
+  return result;
+#endif
+}
+
+// SIMD_SHUFFLE picks lanes of two vectors of the same type by the constant
+// indices, lanes of b follow lanes of a.
+#if __has_builtin(__builtin_shufflevector)
+# define SIMD_SHUFFLE(type, a, b, ...) \
+  ((type)__builtin_shufflevector((a), (b), __VA_ARGS__))
+#else
+# define SIMD_SHUFFLE(type, a, b, ...) \
+  ((type)__builtin_shuffle((a), (b), (type){ __VA_ARGS__ }))
+#endif
+
+// Interleaving of the low and high halves of two vectors, lanes of a take
+// even positions of the result.
+local inline u8x16 u8x16InterleaveLow(u8x16 a, u8x16 b) {
+  return SIMD_SHUFFLE(u8x16, a, b, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+}
+
+local inline u8x16 u8x16InterleaveHigh(u8x16 a, u8x16 b) {
+  return SIMD_SHUFFLE(u8x16, a, b, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+}
+
+local inline u16x8 u16x8InterleaveLow(u16x8 a, u16x8 b) {
+  return SIMD_SHUFFLE(u16x8, a, b, 0, 8, 1, 9, 2, 10, 3, 11);
+}
+
+local inline u16x8 u16x8InterleaveHigh(u16x8 a, u16x8 b) {
+  return SIMD_SHUFFLE(u16x8, a, b, 4, 12, 5, 13, 6, 14, 7, 15);
+}
+
+// f32x4Select picks lanes from a where mask is set and from b otherwise.
+local inline f32x4 f32x4Select(i32x4 mask, f32x4 a, f32x4 b) {
+  return (f32x4)((mask & (i32x4)a) | (~mask & (i32x4)b));
+}
+
+local inline f32x4 f32x4Min(f32x4 a, f32x4 b) {
+  return f32x4Select(a < b, a, b);
+}
+
+local inline f32x4 f32x4Max(f32x4 a, f32x4 b) {
+  return f32x4Select(a > b, a, b);
+}
+
+local inline f32x4 f32x4Clamp(f32x4 v, f32 min, f32 max) {
+  return f32x4Min(f32x4Max(v, f32x4Splat(min)), f32x4Splat(max));
+}
+
+// f32x4Exp approximates e^x with relative error below 4e-6 for the
+// arguments in range [-87, 87]; arguments outside of it are clamped.
+local inline f32x4 f32x4Exp(f32x4 x) {
+  f32x4 t = f32x4Clamp(x * 1.44269504f, -126.0f, 126.0f);
+
+  // floor(t), conversion truncates towards zero.
+  f32x4 n = __builtin_convertvector(__builtin_convertvector(t, i32x4), f32x4);
+  n -= f32x4Select(n > t, f32x4Splat(1.0f), f32x4Splat(0.0f));
+
+  // 2^f for f in [0, 1)
+  f32x4 f = t - n;
+  f32x4 p = f32x4Splat(1.8775767e-3f);
+  p = p * f + 8.9893397e-3f;
+  p = p * f + 5.5826318e-2f;
+  p = p * f + 2.4015361e-1f;
+  p = p * f + 6.9315308e-1f;
+  p = p * f + 9.9999994e-1f;
+
+  i32x4 exponent = (__builtin_convertvector(n, i32x4) + 127) << 23;
+  return p * (f32x4)exponent;
+}
+
+#endif
@@ -0,0 +1,83 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// tablegen writes lookup tables declared in tables.h into the blob given by
+// the argument, the build embeds the blob into cube with tables.S:
+//   tablegen tables.bin
+
+#include <stdio.h>
+
+#include "kociemba.h"
+#include "tables.h"
+#include "workers.h"
+
+// tablegenWrite writes the table padded to the start of the next table.
+local bool tablegenWrite(FILE* file, const void* table, u64 size) {
+  static const u8 padding[TABLES_ALIGN];
+  u64 padded = tablesOffset(size);
+  return fwrite(table, 1, size, file) == size
+    && fwrite(padding, 1, padded - size, file) == padded - size;
+}
+
+i32 main(i32 argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: tablegen OUTPUT\n");
+    return 1;
+  }
+
+  workersInit(0);
+  Kociemba solver;
+  kociembaInit(&solver, NULL);
+
+  const void* tables[TABLES_COUNT];
+  usize sizes[TABLES_COUNT];
+  tables[TABLE_KOCIEMBA] = kociembaTables(&solver, &sizes[TABLE_KOCIEMBA]);
+
+  TablesHeader header = {
+    .magic   = TABLES_MAGIC,
+    .version = TABLES_VERSION,
+  };
+  for (u32 t = 0; t < TABLES_COUNT; t++) {
+    header.sizes[t] = sizes[t];
+  }
+
+  FILE* file = fopen(argv[1], "wb");
+  if (file == NULL) {
+    fprintf(stderr, "Failed to open %s\n", argv[1]);
+    return 1;
+  }
+
+  bool written = tablegenWrite(file, &header, sizeof(header));
+  for (u32 t = 0; t < TABLES_COUNT && written; t++) {
+    written = tablegenWrite(file, tables[t], sizes[t]);
+  }
+  written = fclose(file) == 0 && written;
+
+  kociembaFree(&solver);
+  workersClose();
+
+  if (!written) {
+    fprintf(stderr, "Failed to write %s\n", argv[1]);
+    remove(argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "tables.h"
+
+#ifdef TABLES_EMBEDDED
+
+// Blob is defined by tables.S.
+extern const u8 tables_blob[];
+extern const u8 tables_blob_end[];
+
+const void* tablesGet(Table table, usize size) {
+  u64 length = (u64)(tables_blob_end - tables_blob);
+  if (length < sizeof(TablesHeader)) {
+    return NULL;
+  }
+
+  const TablesHeader* header = (const TablesHeader*)tables_blob;
+  if (header->magic != TABLES_MAGIC || header->version != TABLES_VERSION
+      || header->sizes[table] != size) {
+    return NULL;
+  }
+
+  u64 offset = tablesOffset(sizeof(TablesHeader));
+  for (u32 t = 0; t < table; t++) {
+    offset = tablesOffset(offset + header->sizes[t]);
+  }
+  if (offset + size > length) {
+    return NULL;
+  }
+  return tables_blob + offset;
+}
+
+#else
+
+const void* tablesGet(Table table, usize size) {
+  (void)table;
+  (void)size;
+  return NULL;
+}
+
+#endif
@@ -0,0 +1,79 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _TABLES_H
+#define _TABLES_H
+
+// Lookup tables generated at build time by tablegen. The generator writes
+// them into the single blob that tables.S embeds into the read-only data
+// of cube with .incbin, the blob is a plain copy of the memory the code
+// would compute, so it is neither parsed nor compiled. Binary built without
+// the blob computes the tables at runtime.
+//
+// Only tables that are too slow to compute on every start are embedded,
+// the others stay runtime:
+//   - Rubik permutation tables depend on the cube size picked by the user,
+//     rubikInit computes them in O(size^2).
+//   - Hashlife block table depends on the rule, all 2^16 blocks are counted
+//     in a few milliseconds.
+//   - Palette shuffles depend on the colors of the palette.
+// New table gets the entry of Table, tablegen writes it and the module
+// reads it with tablesGet.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  // Move tables and pattern databases of the two-phase solver.
+  TABLE_KOCIEMBA = 0,
+  TABLES_COUNT   = 1,
+} Table;
+
+#define TABLES_MAGIC   0x31424154u
+#define TABLES_VERSION 1
+// Every table of the blob starts at the multiple of this.
+#define TABLES_ALIGN   64
+
+// Header of the blob, tables follow it in the order of Table.
+typedef struct {
+  u32 magic;
+  u32 version;
+  u64 sizes[TABLES_COUNT];
+} TablesHeader;
+
+// tablesOffset returns offset of the table that follows the data of the
+// given size in the blob.
+local inline u64 tablesOffset(u64 size) {
+  return (size + TABLES_ALIGN - 1) & ~(u64)(TABLES_ALIGN - 1);
+}
+
+// tablesGet returns the embedded table, or NULL when the binary is built
+// without the blob or the blob does not have the table of that size.
+const void* tablesGet(Table table, usize size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,342 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "tiled.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+#include "workers.h"
+
+// Tile is updated in the scratch copy surrounded by one cell of the halo.
+#define HALO_SIZE (TILE_SIZE + 2)
+
+// tiledFieldMorton interleaves bits of the tile coordinates.
+local u64 tiledFieldMorton(u32 x, u32 y) {
+  u64 key = 0;
+  for (u32 bit = 0; bit < 32; bit++) {
+    key |= (u64)((x >> bit) & 1) << (2 * bit);
+    key |= (u64)((y >> bit) & 1) << (2 * bit + 1);
+  }
+  return key;
+}
+
+// tiledTileNew allocates empty tile with the single reference.
+local TiledTile* tiledTileNew(void) {
+  TiledTile* tile = gcalloc(1, sizeof(TiledTile));
+  tile->refs = 1;
+  return tile;
+}
+
+// tiledTileRetain adds reference to the tile.
+local TiledTile* tiledTileRetain(TiledTile* tile) {
+  __atomic_add_fetch(&tile->refs, 1, __ATOMIC_RELAXED);
+  return tile;
+}
+
+// tiledTileRelease drops reference to the tile, the last one frees it.
+local void tiledTileRelease(TiledTile* tile) {
+  if (tile != NULL && __atomic_sub_fetch(&tile->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+    gfree(tile);
+  }
+}
+
+// tiledTileExclusive reports whether the caller holds the only reference
+// to the tile, so the tile may be written in place.
+local bool tiledTileExclusive(TiledTile* tile) {
+  return __atomic_load_n(&tile->refs, __ATOMIC_ACQUIRE) == 1;
+}
+
+local i32 tiledFieldCompare(const void* a, const void* b) {
+  u64 ka = *(const u64*)a;
+  u64 kb = *(const u64*)b;
+  return (ka > kb) - (ka < kb);
+}
+
+void tiledFieldInit(TiledField* field, u32 width, u32 height, Rule rule) {
+  assertf((width & (TILE_SIZE - 1)) == 0 && (height & (TILE_SIZE - 1)) == 0,
+      "Tiled field size must be multiple of %u, got %ux%u", TILE_SIZE, width, height);
+
+  u32 tiles_x = width / TILE_SIZE;
+  u32 tiles_y = height / TILE_SIZE;
+  u32 count   = tiles_x * tiles_y;
+
+  field->width      = width;
+  field->height     = height;
+  field->tiles_x    = tiles_x;
+  field->tiles_y    = tiles_y;
+  field->rule       = rule;
+  field->generation = 0;
+
+  field->slots   = gmalloc(count * sizeof(u32));
+  field->slot_x  = gmalloc(count * sizeof(u32));
+  field->slot_y  = gmalloc(count * sizeof(u32));
+  field->current = gmalloc(count * sizeof(TiledTile*));
+  field->next    = gcalloc(count, sizeof(TiledTile*));
+  for (u32 slot = 0; slot < count; slot++) {
+    field->current[slot] = tiledTileNew();
+  }
+
+  // Field need not be a square of the power of two, so slots are assigned
+  // by sorting tiles by their Morton keys. Tile index fits into the low
+  // bits of the key, because keys of the tiles are unique.
+  u64* keys = gmalloc(count * sizeof(u64));
+  for (u32 i = 0; i < count; i++) {
+    keys[i] = (tiledFieldMorton(i % tiles_x, i / tiles_x) << 32) | i;
+  }
+  qsort(keys, count, sizeof(u64), tiledFieldCompare);
+
+  for (u32 slot = 0; slot < count; slot++) {
+    u32 tile = (u32)keys[slot];
+    field->slots[tile]  = slot;
+    field->slot_x[slot] = tile % tiles_x;
+    field->slot_y[slot] = tile / tiles_x;
+  }
+  gfree(keys);
+}
+
+void tiledFieldFree(TiledField* field) {
+  u32 count = field->tiles_x * field->tiles_y;
+  for (u32 slot = 0; slot < count; slot++) {
+    tiledTileRelease(field->current[slot]);
+    tiledTileRelease(field->next[slot]);
+  }
+  gfree(field->slots);
+  gfree(field->slot_x);
+  gfree(field->slot_y);
+  gfree(field->current);
+  gfree(field->next);
+}
+
+void tiledFieldFork(TiledField* fork, TiledField* parent) {
+  u32 count = parent->tiles_x * parent->tiles_y;
+
+  *fork = *parent;
+  fork->slots   = gmalloc(count * sizeof(u32));
+  fork->slot_x  = gmalloc(count * sizeof(u32));
+  fork->slot_y  = gmalloc(count * sizeof(u32));
+  fork->current = gmalloc(count * sizeof(TiledTile*));
+  fork->next    = gcalloc(count, sizeof(TiledTile*));
+  memcpy(fork->slots, parent->slots, count * sizeof(u32));
+  memcpy(fork->slot_x, parent->slot_x, count * sizeof(u32));
+  memcpy(fork->slot_y, parent->slot_y, count * sizeof(u32));
+
+  for (u32 slot = 0; slot < count; slot++) {
+    fork->current[slot] = tiledTileRetain(parent->current[slot]);
+  }
+}
+
+// tiledFieldTile returns cells of the tile at the tile coordinates,
+// coordinates are wrapped.
+local const u8* tiledFieldTile(TiledField* field, TiledTile** tiles, i32 tx, i32 ty) {
+  tx = modi32(tx, field->tiles_x);
+  ty = modi32(ty, field->tiles_y);
+  return tiles[field->slots[ty * field->tiles_x + tx]]->cells;
+}
+
+// tiledFieldOwn copies the current tile of the slot when it is shared and
+// returns its cells for writing.
+local u8* tiledFieldOwn(TiledField* field, u32 slot) {
+  TiledTile* tile = field->current[slot];
+  if (!tiledTileExclusive(tile)) {
+    TiledTile* copy = tiledTileNew();
+    memcpy(copy->cells, tile->cells, TILE_CELLS);
+    tiledTileRelease(tile);
+    field->current[slot] = copy;
+  }
+  return field->current[slot]->cells;
+}
+
+State tiledFieldCellState(TiledField* field, i32 x, i32 y) {
+  x = modi32(x, field->width);
+  y = modi32(y, field->height);
+  const u8* tile = tiledFieldTile(field, field->current, x / TILE_SIZE, y / TILE_SIZE);
+  return tile[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE];
+}
+
+void tiledFieldCellSet(TiledField* field, i32 x, i32 y, State state) {
+  x = modi32(x, field->width);
+  y = modi32(y, field->height);
+  u32 slot = field->slots[(y / TILE_SIZE) * field->tiles_x + x / TILE_SIZE];
+  if (field->current[slot]->cells[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE] == state) {
+    return;
+  }
+  tiledFieldOwn(field, slot)[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE] = state;
+}
+
+void tiledFieldFromField(TiledField* field, Field* source) {
+  assertf(source->width == field->width && source->height == field->height,
+      "Field size %ux%u does not match %ux%u",
+      source->width, source->height, field->width, field->height);
+
+  for (u32 y = 0; y < field->height; y++) {
+    const u8* row = source->current + (usize)y * source->pitch;
+    u32 offset    = (y % TILE_SIZE) * TILE_SIZE;
+    for (u32 tx = 0; tx < field->tiles_x; tx++) {
+      u32 slot = field->slots[(y / TILE_SIZE) * field->tiles_x + tx];
+      const u8* cells = row + tx * TILE_SIZE;
+      if (memcmp(field->current[slot]->cells + offset, cells, TILE_SIZE) != 0) {
+        memcpy(tiledFieldOwn(field, slot) + offset, cells, TILE_SIZE);
+      }
+    }
+  }
+}
+
+void tiledFieldToField(TiledField* field, Field* target) {
+  assertf(target->width == field->width && target->height == field->height,
+      "Field size %ux%u does not match %ux%u",
+      target->width, target->height, field->width, field->height);
+
+  for (u32 y = 0; y < field->height; y++) {
+    u8* row = target->current + (usize)y * target->pitch;
+    u8 changed = 0;
+    for (u32 tx = 0; tx < field->tiles_x; tx++) {
+      const u8* tile = tiledFieldTile(field, field->current, tx, y / TILE_SIZE);
+      const u8* cells = tile + (y % TILE_SIZE) * TILE_SIZE;
+      changed |= memcmp(row + tx * TILE_SIZE, cells, TILE_SIZE) != 0;
+      memcpy(row + tx * TILE_SIZE, cells, TILE_SIZE);
+    }
+    target->changed[y] = changed;
+  }
+}
+
+u32 tiledFieldDiffer(TiledField* field, TiledField* other) {
+  assertf(other->width == field->width && other->height == field->height,
+      "Field size %ux%u does not match %ux%u",
+      other->width, other->height, field->width, field->height);
+
+  u32 count  = field->tiles_x * field->tiles_y;
+  u32 differ = 0;
+  for (u32 i = 0; i < count; i++) {
+    const TiledTile* a = field->current[field->slots[i]];
+    const TiledTile* b = other->current[other->slots[i]];
+    differ += a != b && memcmp(a->cells, b->cells, TILE_CELLS) != 0;
+  }
+  return differ;
+}
+
+void tiledFieldViewport(TiledField* field, i32 x, i32 y, u32 width, u32 height,
+    u8* states) {
+  for (u32 row = 0; row < height; row++) {
+    i32 cy = modi32(y + (i32)(row % field->height), field->height);
+    u8* out = states + (usize)row * width;
+
+    // Row of the viewport is copied in runs that end at the tile edges.
+    for (u32 column = 0; column < width;) {
+      i32 cx  = modi32(x + (i32)(column % field->width), field->width);
+      u32 run = min_value(TILE_SIZE - (u32)cx % TILE_SIZE, width - column);
+      const u8* tile = tiledFieldTile(field, field->current,
+          cx / TILE_SIZE, cy / TILE_SIZE);
+      memcpy(out + column, tile + (cy % TILE_SIZE) * TILE_SIZE + cx % TILE_SIZE, run);
+      column += run;
+    }
+  }
+}
+
+// tiledFieldHalo copies tile together with the edge cells of the eight
+// neighboring tiles into the scratch of HALO_SIZE x HALO_SIZE cells.
+local void tiledFieldHalo(TiledField* field, u32 slot, u8* scratch) {
+  i32 tx = field->slot_x[slot];
+  i32 ty = field->slot_y[slot];
+  TiledTile** tiles = field->current;
+
+  const u8* center = tiles[slot]->cells;
+  const u8* north  = tiledFieldTile(field, tiles, tx,     ty - 1);
+  const u8* south  = tiledFieldTile(field, tiles, tx,     ty + 1);
+  const u8* west   = tiledFieldTile(field, tiles, tx - 1, ty);
+  const u8* east   = tiledFieldTile(field, tiles, tx + 1, ty);
+
+  const u32 last = TILE_SIZE - 1;
+  for (u32 y = 0; y < TILE_SIZE; y++) {
+    u8* row = scratch + (y + 1) * HALO_SIZE;
+    row[0] = west[y * TILE_SIZE + last];
+    memcpy(row + 1, center + y * TILE_SIZE, TILE_SIZE);
+    row[TILE_SIZE + 1] = east[y * TILE_SIZE];
+  }
+
+  u8* top    = scratch;
+  u8* bottom = scratch + (TILE_SIZE + 1) * HALO_SIZE;
+  memcpy(top + 1, north + last * TILE_SIZE, TILE_SIZE);
+  memcpy(bottom + 1, south, TILE_SIZE);
+
+  top[0]                = tiledFieldTile(field, tiles, tx - 1, ty - 1)[TILE_CELLS - 1];
+  top[TILE_SIZE + 1]    = tiledFieldTile(field, tiles, tx + 1, ty - 1)[last * TILE_SIZE];
+  bottom[0]             = tiledFieldTile(field, tiles, tx - 1, ty + 1)[last];
+  bottom[TILE_SIZE + 1] = tiledFieldTile(field, tiles, tx + 1, ty + 1)[0];
+}
+
+#define ALIVE_AT(row, col) ((row)[col] == ALIVE)
+
+local void tiledFieldTiles(void* ctx, u32 begin, u32 end) {
+  TiledField* field = ctx;
+  Rule rule = field->rule;
+  u8 scratch[HALO_SIZE * HALO_SIZE];
+  u8 cells[TILE_CELLS];
+
+  for (u32 slot = begin; slot < end; slot++) {
+    tiledFieldHalo(field, slot, scratch);
+
+    // Tile of the next generation is written in place when nobody else
+    // holds it, otherwise cells go to the stack first.
+    TiledTile* current = field->current[slot];
+    TiledTile* tile    = field->next[slot];
+    bool in_place = tile != NULL && tiledTileExclusive(tile);
+    u8* next = in_place ? tile->cells : cells;
+
+    for (u32 y = 0; y < TILE_SIZE; y++) {
+      const u8* n = scratch + y * HALO_SIZE;
+      const u8* c = n + HALO_SIZE;
+      const u8* s = c + HALO_SIZE;
+
+      for (u32 x = 1; x <= TILE_SIZE; x++) {
+        u32 count = ALIVE_AT(n, x - 1) + ALIVE_AT(n, x) + ALIVE_AT(n, x + 1)
+                  + ALIVE_AT(c, x - 1) +                  ALIVE_AT(c, x + 1)
+                  + ALIVE_AT(s, x - 1) + ALIVE_AT(s, x) + ALIVE_AT(s, x + 1);
+        u8 state  = c[x];
+        u32 mask  = state == ALIVE ? rule.survival : rule.birth;
+        next[y * TILE_SIZE + x - 1] = (mask >> count) & 1 ? ALIVE : fieldFade(state);
+      }
+    }
+
+    // Tile that did not change is shared by both generations, so it stays
+    // shared with the forks as well.
+    if (memcmp(next, current->cells, TILE_CELLS) == 0) {
+      tiledTileRelease(tile);
+      field->next[slot] = tiledTileRetain(current);
+    } else if (!in_place) {
+      tiledTileRelease(tile);
+      field->next[slot] = tiledTileNew();
+      memcpy(field->next[slot]->cells, cells, TILE_CELLS);
+    }
+  }
+}
+
+void tiledFieldUpdate(TiledField* field) {
+  // Consecutive slots are close on the plane, so every worker gets compact
+  // region of the field.
+  workersRun(field->tiles_x * field->tiles_y, tiledFieldTiles, field);
+
+  TiledTile** tmp = field->current;
+  field->current = field->next;
+  field->next    = tmp;
+  field->generation++;
+}
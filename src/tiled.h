@@ -0,0 +1,118 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _TILED_H
+#define _TILED_H
+
+#include "types.h"
+#include "field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Side of the square tile, single tile occupies one page of memory.
+#define TILE_SIZE  64
+#define TILE_CELLS (TILE_SIZE * TILE_SIZE)
+
+// TiledTile holds cells of the tile, it is shared by the forks of the
+// field and by both generations of the field while the tile does not
+// change. Shared tiles are copied before they are written.
+typedef struct {
+  u8 cells[TILE_CELLS];
+  // Number of the references from the tiles of the fields.
+  u32 refs;
+} TiledTile;
+
+// TiledField is the life field on the torus stored as 64x64 tiles, cells
+// of the tile are contiguous and tiles follow the Morton (Z-order) curve
+// of their coordinates. Vertical neighbors are at most one tile apart, so
+// wide fields do not thrash cache and TLB. It uses the Moore neighborhood
+// and gives the same states as the Field with the deterministic rule.
+typedef struct {
+  // Size of the field in cells, multiples of TILE_SIZE.
+  u32 width;
+  u32 height;
+  // Number of the tiles in the row and in the column.
+  u32 tiles_x;
+  u32 tiles_y;
+  // Slot of the tile in the storage for every tile in the row-major order
+  // of their coordinates.
+  u32* slots;
+  // Tile coordinates of every slot.
+  u32* slot_x;
+  u32* slot_y;
+  // Rule of the automaton.
+  Rule rule;
+
+  // Tiles of the current and the next generation in the order of the
+  // slots. Tile of the next generation is NULL until it is computed.
+  TiledTile** current;
+  TiledTile** next;
+
+  // Number of generations since the start.
+  u64 generation;
+} TiledField;
+
+void tiledFieldInit(TiledField* field, u32 width, u32 height, Rule rule);
+
+// tiledFieldFree drops references to the tiles, tiles are freed when the
+// last field that shares them is freed.
+void tiledFieldFree(TiledField* field);
+
+// tiledFieldFork creates field that shares all tiles of the current
+// generation with the parent, it takes time proportional to the number of
+// the tiles. Both fields advance independently and copy shared tiles only
+// when they change.
+void tiledFieldFork(TiledField* fork, TiledField* parent);
+
+// tiledFieldCellState returns state of the cell, coordinates are wrapped.
+State tiledFieldCellState(TiledField* field, i32 x, i32 y);
+
+// tiledFieldCellSet sets state of the cell, coordinates are wrapped.
+void tiledFieldCellSet(TiledField* field, i32 x, i32 y, State state);
+
+// tiledFieldFromField copies cells of the row-major field of the same size,
+// tiles where cells do not change stay shared.
+void tiledFieldFromField(TiledField* field, Field* source);
+
+// tiledFieldToField copies cells into the row-major field of the same size
+// and flags its rows that change.
+void tiledFieldToField(TiledField* field, Field* target);
+
+// tiledFieldDiffer returns number of the tiles where cells of the fields of
+// the same size differ, shared tiles are not compared.
+u32 tiledFieldDiffer(TiledField* field, TiledField* other);
+
+// tiledFieldViewport writes states of the cells of the rectangle with the
+// top left corner at (x, y) row by row, coordinates are wrapped.
+void tiledFieldViewport(TiledField* field, i32 x, i32 y, u32 width, u32 height,
+    u8* states);
+
+// tiledFieldUpdate advances field by single generation. Tiles that do not
+// change keep being shared.
+void tiledFieldUpdate(TiledField* field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -219,6 +219,12 @@ extern "C" {
 
 bool f64eq(f64 a, f64 b);
 
+// modi32 returns a modulo b wrapped into range [0, b), b must be positive.
+local inline i32 modi32(i32 a, i32 b) {
+  i32 r = a % b;
+  return r < 0 ? r + b : r;
+}
+
 #define DECL_SWAP_INT(T) \
   inline void swap##T(T* a, T* b) { \
      *a ^= *b; \
@@ -0,0 +1,61 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vectors.h"
+
+#include <string.h>
+
+#include "debug.h"
+#include "simd.h"
+
+// vectorsLanes returns size of the arrays of the batch.
+local inline u32 vectorsLanes(u32 count) {
+  return (count + F32X4_LANES - 1) / F32X4_LANES * F32X4_LANES;
+}
+
+void vectorsInit(Vectors* vectors, u32 count) {
+  u32 lanes = vectorsLanes(count);
+  vectors->x     = gcalloc(lanes, sizeof(f32));
+  vectors->y     = gcalloc(lanes, sizeof(f32));
+  vectors->z     = gcalloc(lanes, sizeof(f32));
+  vectors->count = count;
+}
+
+void vectorsFree(Vectors* vectors) {
+  gfree(vectors->x);
+  gfree(vectors->y);
+  gfree(vectors->z);
+}
+
+void vectorsTransform(Vectors* target, const Vectors* source, f32 scale,
+    const f32 offset[3]) {
+  assertf(target->count == source->count, "Expected %u vectors, got %u",
+      source->count, target->count);
+
+  f32x4 ox = f32x4Splat(offset[0]);
+  f32x4 oy = f32x4Splat(offset[1]);
+  f32x4 oz = f32x4Splat(offset[2]);
+  for (u32 i = 0; i < source->count; i += F32X4_LANES) {
+    f32x4Store(target->x + i, f32x4Load(source->x + i) * scale + ox);
+    f32x4Store(target->y + i, f32x4Load(source->y + i) * scale + oy);
+    f32x4Store(target->z + i, f32x4Load(source->z + i) * scale + oz);
+  }
+}
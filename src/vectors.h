@@ -0,0 +1,63 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _VECTORS_H
+#define _VECTORS_H
+
+// Batches of 3D vectors stored as structure of arrays, so every operation
+// processes four vectors per SIMD instruction.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  // Components of the vectors, arrays are padded with zeros to the
+  // multiple of F32X4_LANES.
+  f32* x;
+  f32* y;
+  f32* z;
+  u32 count;
+} Vectors;
+
+// vectorsInit allocates zeroed batch of the given number of vectors.
+void vectorsInit(Vectors* vectors, u32 count);
+void vectorsFree(Vectors* vectors);
+
+// vectorsSet sets vector i of the batch.
+local inline void vectorsSet(Vectors* vectors, u32 i, f32 x, f32 y, f32 z) {
+  vectors->x[i] = x;
+  vectors->y[i] = y;
+  vectors->z[i] = z;
+}
+
+// vectorsTransform writes vectors of the source scaled and moved by the
+// offset into the target of the same size, out = v * scale + offset.
+void vectorsTransform(Vectors* target, const Vectors* source, f32 scale,
+    const f32 offset[3]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
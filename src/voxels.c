@@ -0,0 +1,277 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "voxels.h"
+
+#include <string.h>
+
+#include "debug.h"
+#include "workers.h"
+
+// Brightness of the faces in 1/256 by the direction of their normal: +x,
+// -x, +y, -y, +z, -z. Light falls from above, so the top is the brightest.
+local const u32 voxels_shades[6] = { 208, 176, 256, 128, 224, 160 };
+
+void voxelsInit(Voxels* voxels, u32 width, u32 height, u32 depth, const u32* colors) {
+  assertf(width > 0 && height > 0 && depth > 0, "empty volume %ux%ux%u",
+      width, height, depth);
+  assertf(((width | height | depth) & (VOXELS_CHUNK - 1)) == 0,
+      "volume %ux%ux%u is not made of whole chunks", width, height, depth);
+
+  voxels->width   = width;
+  voxels->height  = height;
+  voxels->depth   = depth;
+  voxels->columns = width / VOXELS_CHUNK;
+  voxels->rows    = depth / VOXELS_CHUNK;
+  voxels->layers  = height / VOXELS_CHUNK;
+  voxels->voxels  = gcalloc((usize)width * height * depth, sizeof(u8));
+  memcpy(voxels->colors, colors, sizeof(voxels->colors));
+
+  u32 count = voxels->columns * voxels->rows * voxels->layers;
+  voxels->chunks      = gcalloc(count, sizeof(VoxelChunk));
+  voxels->dirty       = gmalloc(count * sizeof(u32));
+  voxels->dirty_count = 0;
+  voxels->meshed      = false;
+  voxels->occlusion   = true;
+}
+
+void voxelsFree(Voxels* voxels) {
+  u32 count = voxels->columns * voxels->rows * voxels->layers;
+  for (u32 i = 0; i < count; i++) {
+    VoxelMesh* mesh = &voxels->chunks[i].mesh;
+    if (mesh->capacity > 0) {
+      gfree(mesh->vertices);
+      gfree(mesh->colors);
+    }
+  }
+  gfree(voxels->dirty);
+  gfree(voxels->chunks);
+  gfree(voxels->voxels);
+}
+
+// voxelsMark marks the chunk dirty, coordinates are in chunks and may be
+// outside of the volume.
+local void voxelsMark(Voxels* voxels, i32 cx, i32 cy, i32 cz) {
+  if ((u32)cx >= voxels->columns || (u32)cz >= voxels->rows || (u32)cy >= voxels->layers) {
+    return;
+  }
+
+  u32 index = ((u32)cy * voxels->rows + cz) * voxels->columns + cx;
+  if (!voxels->chunks[index].dirty) {
+    voxels->chunks[index].dirty = true;
+    voxels->dirty[voxels->dirty_count++] = index;
+  }
+}
+
+void voxelsSet(Voxels* voxels, u32 x, u32 y, u32 z, u8 color) {
+  assertf(color < VOXELS_COLORS, "invalid voxel color %u", color);
+
+  usize index = voxelsIndex(voxels, x, y, z);
+  if (voxels->voxels[index] == color) {
+    return;
+  }
+  voxels->voxels[index] = color;
+
+  if (voxels->meshed) {
+    voxels->meshed      = false;
+    voxels->dirty_count = 0;
+  }
+
+  // Faces on the borders of the chunk are culled and shaded by the voxels
+  // of the neighbor chunks, including the chunks across the edges and the
+  // corners.
+  i32 c[3] = { x / VOXELS_CHUNK, y / VOXELS_CHUNK, z / VOXELS_CHUNK };
+  u32 l[3] = { x % VOXELS_CHUNK, y % VOXELS_CHUNK, z % VOXELS_CHUNK };
+  i32 from[3], to[3];
+  for (u32 k = 0; k < 3; k++) {
+    from[k] = c[k] - (l[k] == 0);
+    to[k]   = c[k] + (l[k] == VOXELS_CHUNK - 1);
+  }
+  for (i32 cy = from[1]; cy <= to[1]; cy++) {
+    for (i32 cz = from[2]; cz <= to[2]; cz++) {
+      for (i32 cx = from[0]; cx <= to[0]; cx++) {
+        voxelsMark(voxels, cx, cy, cz);
+      }
+    }
+  }
+}
+
+void voxelsSetOcclusion(Voxels* voxels, bool occlusion) {
+  if (voxels->occlusion == occlusion) {
+    return;
+  }
+  voxels->occlusion = occlusion;
+
+  if (voxels->meshed) {
+    voxels->meshed      = false;
+    voxels->dirty_count = 0;
+  }
+  for (u32 cy = 0; cy < voxels->layers; cy++) {
+    for (u32 cz = 0; cz < voxels->rows; cz++) {
+      for (u32 cx = 0; cx < voxels->columns; cx++) {
+        voxelsMark(voxels, cx, cy, cz);
+      }
+    }
+  }
+}
+
+// Side of the block of the voxels of the chunk with the border of the
+// neighbor voxels.
+#define VOXELS_BLOCK (VOXELS_CHUNK + 2)
+
+// voxelsBlock returns index of the voxel of the block, coordinates are
+// local to the chunk and go from -1 to VOXELS_CHUNK.
+local inline u32 voxelsBlock(i32 x, i32 y, i32 z) {
+  return ((y + 1) * VOXELS_BLOCK + z + 1) * VOXELS_BLOCK + x + 1;
+}
+
+// Brightness of the corners in 1/256 by the number of the occluding voxels
+// around them, the corner between two voxels is fully occluded.
+local const u32 voxels_occlusion[4] = { 256, 208, 168, 128 };
+
+// voxelsFace appends face of the voxel at the local position in the
+// direction, directions go as +x, -x, +y, -y, +z, -z. With the occlusion
+// on, each corner is darkened by the voxels in front of the face that touch it.
+local void voxelsFace(VoxelMesh* mesh, const u8* block, u32 direction,
+    const i32 position[3], u32 color, bool occlusion) {
+  if (mesh->faces == mesh->capacity) {
+    mesh->capacity = max_value(2 * mesh->capacity, 64u);
+    mesh->vertices = grealloc(mesh->vertices, mesh->capacity * 18 * sizeof(f32));
+    mesh->colors   = grealloc(mesh->colors, mesh->capacity * 24 * sizeof(u8));
+  }
+
+  u32 axis = direction / 2;
+  u32 u    = (axis + 1) % 3;
+  u32 v    = (axis + 2) % 3;
+  bool positive = (direction & 1) == 0;
+
+  // Corners of the face in the order (0, 0), (1, 0), (1, 1), (0, 1), the
+  // occluding voxels are the voxels in front of the face that touch the
+  // corner: two on the sides and one on the diagonal.
+  u32 levels[4] = { 0 };
+  if (occlusion) {
+    i32 front[3] = { position[0], position[1], position[2] };
+    front[axis] += positive ? 1 : -1;
+    local const i32 signs[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    for (u32 c = 0; c < 4; c++) {
+      i32 a[3] = { front[0], front[1], front[2] };
+      i32 b[3] = { front[0], front[1], front[2] };
+      a[u] += signs[c][0];
+      b[v] += signs[c][1];
+      bool side_a = block[voxelsBlock(a[0], a[1], a[2])] != 0;
+      bool side_b = block[voxelsBlock(b[0], b[1], b[2])] != 0;
+      a[v] += signs[c][1];
+      bool diagonal = block[voxelsBlock(a[0], a[1], a[2])] != 0;
+      levels[c] = side_a && side_b ? 3 : side_a + side_b + diagonal;
+    }
+  }
+
+  // Triangles go counterclockwise when looking at the face from outside.
+  // Face is split along the diagonal with less occlusion, so the darker
+  // corner does not bleed over the whole face.
+  local const u8 splits[2][6] = {
+    { 0, 1, 2, 0, 2, 3 },
+    { 1, 2, 3, 1, 3, 0 },
+  };
+  local const u8 corners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+  const u8* split = splits[levels[0] + levels[2] > levels[1] + levels[3]];
+
+  u8 rgba[4];
+  memcpy(rgba, &color, sizeof(rgba));
+  u32 shade = voxels_shades[direction];
+
+  f32* vertices = mesh->vertices + mesh->faces * 18;
+  u8* colors    = mesh->colors + mesh->faces * 24;
+  for (u32 i = 0; i < 6; i++) {
+    u32 corner = split[positive ? i : 5 - i];
+    vertices[i * 3 + axis] = position[axis] + positive;
+    vertices[i * 3 + u]    = position[u] + corners[corner][0];
+    vertices[i * 3 + v]    = position[v] + corners[corner][1];
+
+    u32 light = shade * voxels_occlusion[levels[corner]] >> 8;
+    for (u32 k = 0; k < 3; k++) {
+      colors[i * 4 + k] = rgba[k] * light >> 8;
+    }
+    colors[i * 4 + 3] = rgba[3];
+  }
+  mesh->faces++;
+}
+
+// voxelsMeshChunk rebuilds mesh of the chunk from the faces of its voxels
+// that are not covered by the neighbors.
+local void voxelsMeshChunk(Voxels* voxels, u32 index) {
+  VoxelChunk* chunk = &voxels->chunks[index];
+  i32 cx = index % voxels->columns * VOXELS_CHUNK;
+  i32 cz = index / voxels->columns % voxels->rows * VOXELS_CHUNK;
+  i32 cy = index / voxels->columns / voxels->rows * VOXELS_CHUNK;
+
+  // Voxels of the chunk and its border are gathered once, so culling and
+  // occlusion read them without the bounds checks.
+  u8 block[VOXELS_BLOCK * VOXELS_BLOCK * VOXELS_BLOCK];
+  for (i32 y = -1; y <= VOXELS_CHUNK; y++) {
+    for (i32 z = -1; z <= VOXELS_CHUNK; z++) {
+      for (i32 x = -1; x <= VOXELS_CHUNK; x++) {
+        block[voxelsBlock(x, y, z)] = voxelsGet(voxels, cx + x, cy + y, cz + z);
+      }
+    }
+  }
+
+  local const i32 offsets[6][3] = {
+    { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 },
+  };
+
+  chunk->mesh.faces = 0;
+  for (i32 y = 0; y < VOXELS_CHUNK; y++) {
+    for (i32 z = 0; z < VOXELS_CHUNK; z++) {
+      for (i32 x = 0; x < VOXELS_CHUNK; x++) {
+        u8 color = block[voxelsBlock(x, y, z)];
+        if (color == 0) {
+          continue;
+        }
+
+        i32 position[3] = { x, y, z };
+        for (u32 d = 0; d < 6; d++) {
+          u8 neighbor = block[voxelsBlock(x + offsets[d][0], y + offsets[d][1], z + offsets[d][2])];
+          if (neighbor == 0) {
+            voxelsFace(&chunk->mesh, block, d, position, voxels->colors[color], voxels->occlusion);
+          }
+        }
+      }
+    }
+  }
+  chunk->dirty = false;
+}
+
+local void voxelsMeshChunks(void* ctx, u32 begin, u32 end) {
+  Voxels* voxels = ctx;
+  for (u32 i = begin; i < end; i++) {
+    voxelsMeshChunk(voxels, voxels->dirty[i]);
+  }
+}
+
+u32 voxelsMesh(Voxels* voxels) {
+  if (voxels->meshed) {
+    return 0;
+  }
+  workersRun(voxels->dirty_count, voxelsMeshChunks, voxels);
+  voxels->meshed = true;
+  return voxels->dirty_count;
+}
@@ -0,0 +1,120 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _VOXELS_H
+#define _VOXELS_H
+
+// Voxel volume split into cubic chunks, every chunk owns the mesh of its
+// visible faces. Chunks are remeshed only when their voxels or voxels on
+// the other side of their faces change.
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Side of the chunk in voxels, sizes of the volume are multiples of it.
+#define VOXELS_CHUNK  16
+// Number of the colors of the voxels, voxel 0 is empty.
+#define VOXELS_COLORS 16
+
+// VoxelMesh holds visible faces of the chunk as pairs of triangles, six
+// vertices per face. Positions are relative to the corner of the chunk,
+// colors have the light of the face and the ambient occlusion baked in.
+typedef struct {
+  // Three coordinates and four color bytes per vertex.
+  f32* vertices;
+  u8* colors;
+  // Number of the faces and number of the faces the arrays can hold.
+  u32 faces;
+  u32 capacity;
+} VoxelMesh;
+
+typedef struct {
+  VoxelMesh mesh;
+  // Set when the mesh is out of date.
+  bool dirty;
+} VoxelChunk;
+
+typedef struct {
+  // Size of the volume in voxels and in chunks.
+  u32 width;
+  u32 height;
+  u32 depth;
+  u32 columns;
+  u32 rows;
+  u32 layers;
+  // Colors of the voxels, x changes fastest, then z, then y.
+  u8* voxels;
+  // Colors as 32-bit pixels in the memory order of the mesh colors.
+  u32 colors[VOXELS_COLORS];
+
+  // Chunks, x changes fastest, then z, then y.
+  VoxelChunk* chunks;
+  // Indices of the dirty chunks, after voxelsMesh indices of the chunks
+  // that were remeshed, the meshed flag is set until the next change.
+  u32* dirty;
+  u32 dirty_count;
+  bool meshed;
+  // Set when corners of the faces are darkened by the voxels around them.
+  bool occlusion;
+} Voxels;
+
+// voxelsInit creates empty volume of the given size, sizes must be
+// multiples of VOXELS_CHUNK. Ambient occlusion is on.
+void voxelsInit(Voxels* voxels, u32 width, u32 height, u32 depth, const u32* colors);
+
+// voxelsFree frees memory of the volume and the meshes of the chunks.
+void voxelsFree(Voxels* voxels);
+
+// voxelsIndex returns index of the voxel in the array.
+local inline usize voxelsIndex(const Voxels* voxels, u32 x, u32 y, u32 z) {
+  return ((usize)y * voxels->depth + z) * voxels->width + x;
+}
+
+// voxelsGet returns color of the voxel, voxels outside of the volume are
+// empty.
+local inline u8 voxelsGet(const Voxels* voxels, i32 x, i32 y, i32 z) {
+  if ((u32)x >= voxels->width || (u32)y >= voxels->height || (u32)z >= voxels->depth) {
+    return 0;
+  }
+  return voxels->voxels[voxelsIndex(voxels, x, y, z)];
+}
+
+// voxelsSet changes color of the voxel and marks dirty its chunk and the
+// chunks that touch the voxel.
+void voxelsSet(Voxels* voxels, u32 x, u32 y, u32 z, u8 color);
+
+// voxelsSetOcclusion turns baking of the ambient occlusion on or off, all
+// chunks are remeshed.
+void voxelsSetOcclusion(Voxels* voxels, bool occlusion);
+
+// voxelsMesh rebuilds meshes of the dirty chunks on the worker threads.
+// Returns number of the rebuilt chunks, their indices stay in the dirty
+// array until the next change.
+u32 voxelsMesh(Voxels* voxels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "workers.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "debug.h"
+
+#ifndef MAX_WORKERS
+#define MAX_WORKERS 64
+#endif
+
+typedef struct {
+  pthread_t       threads[MAX_WORKERS];
+  u32             count;
+
+  pthread_mutex_t lock;
+  pthread_cond_t  start;
+  pthread_cond_t  done;
+
+  // Job description, valid while pending is not zero.
+  WorkerFunc      func;
+  void*           ctx;
+  u32             total;
+
+  // Generation is incremented every time new job is published, so workers
+  // are able to tell spurious wake ups from the new jobs.
+  u64             generation;
+  u32             pending;
+  bool            stop;
+} Workers;
+
+broad Workers workers = {
+  .count = 1,
+  .lock  = PTHREAD_MUTEX_INITIALIZER,
+  .start = PTHREAD_COND_INITIALIZER,
+  .done  = PTHREAD_COND_INITIALIZER,
+};
+
+// Set for the threads that are currently executing a band of the job.
+broad __thread bool inside_job = false;
+
+local void workersBand(u32 index, u32 total, WorkerFunc func, void* ctx) {
+  u32 begin = (u32)(((u64)total * index) / workers.count);
+  u32 end   = (u32)(((u64)total * (index + 1)) / workers.count);
+  if (begin < end) {
+    inside_job = true;
+    func(ctx, begin, end);
+    inside_job = false;
+  }
+}
+
+local void* workersLoop(void* arg) {
+  u32 index = (u32)(usize)arg;
+  u64 seen  = 0;
+
+  pthread_mutex_lock(&workers.lock);
+  for (;;) {
+    while (!workers.stop && workers.generation == seen) {
+      pthread_cond_wait(&workers.start, &workers.lock);
+    }
+    if (workers.stop) {
+      break;
+    }
+    seen = workers.generation;
+
+    WorkerFunc func = workers.func;
+    void* ctx       = workers.ctx;
+    u32 total       = workers.total;
+    pthread_mutex_unlock(&workers.lock);
+
+    workersBand(index, total, func, ctx);
+
+    pthread_mutex_lock(&workers.lock);
+    if (--workers.pending == 0) {
+      pthread_cond_signal(&workers.done);
+    }
+  }
+  pthread_mutex_unlock(&workers.lock);
+
+  return NULL;
+}
+
+void workersInit(u32 count) {
+  assertf(workers.count == 1, "Workers are already initialized");
+
+  if (count == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    count = online > 0 ? (u32)online : 1;
+  }
+  count = min_value(count, MAX_WORKERS);
+
+  workers.stop  = false;
+  workers.count = count;
+  // Thread with index 0 is the caller of the workersRun.
+  for (u32 i = 1; i < count; i++) {
+    i32 err = pthread_create(&workers.threads[i], NULL, workersLoop, (void*)(usize)i);
+    assertf(err == 0, "Failed to create worker thread: %s", strerror(err));
+  }
+
+  debugf("Started %u worker threads", count);
+}
+
+void workersClose(void) {
+  pthread_mutex_lock(&workers.lock);
+  workers.stop = true;
+  pthread_cond_broadcast(&workers.start);
+  pthread_mutex_unlock(&workers.lock);
+
+  for (u32 i = 1; i < workers.count; i++) {
+    pthread_join(workers.threads[i], NULL);
+  }
+  workers.count = 1;
+}
+
+u32 workersCount(void) {
+  return workers.count;
+}
+
+void workersRun(u32 total, WorkerFunc func, void* ctx) {
+  if (total == 0) {
+    return;
+  }
+
+  if (workers.count == 1 || inside_job) {
+    func(ctx, 0, total);
+    return;
+  }
+
+  pthread_mutex_lock(&workers.lock);
+  workers.func    = func;
+  workers.ctx     = ctx;
+  workers.total   = total;
+  workers.pending = workers.count - 1;
+  workers.generation++;
+  pthread_cond_broadcast(&workers.start);
+  pthread_mutex_unlock(&workers.lock);
+
+  workersBand(0, total, func, ctx);
+
+  pthread_mutex_lock(&workers.lock);
+  while (workers.pending > 0) {
+    pthread_cond_wait(&workers.done, &workers.lock);
+  }
+  pthread_mutex_unlock(&workers.lock);
+}
@@ -0,0 +1,56 @@
+// Copyright 2024, Geogii Chernukhin <nk2ge5k@gmail.com>
+
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _WORKERS_H
+#define _WORKERS_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// WorkerFunc processes items in the range [begin, end) of the job.
+typedef void (*WorkerFunc)(void* ctx, u32 begin, u32 end);
+
+// workersInit starts the shared pool of worker threads. When count is zero
+// the number of online processors is used.
+void workersInit(u32 count);
+
+// workersClose stops worker threads and releases pool resources.
+void workersClose(void);
+
+// workersCount returns number of threads (including the calling one) that
+// take part in every job.
+u32 workersCount(void);
+
+// workersRun splits range [0, total) into contiguous bands, one per thread,
+// and blocks until all bands are processed. The calling thread always
+// processes the first band itself.
+// NOTE: calls made from inside of the worker function are executed
+//  synchronously on the calling thread.
+void workersRun(u32 total, WorkerFunc func, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif